@@ -34,11 +34,21 @@
 #if defined(M2CTX)
 
 #define ATTR_ALIGNED(value)
+#define ATTR_GAME_STATE
 
 #else
 
 #define ATTR_ALIGNED(value) __attribute__((aligned(value)))
 
+// Places a global into the contiguous rollback arena (see netplay/game_state.h)
+#if defined(__APPLE__)
+#define ATTR_GAME_STATE __attribute__((section("__DATA,__game_state")))
+#elif defined(_WIN32)
+#define ATTR_GAME_STATE __attribute__((section(".data$game_state_b")))
+#else
+#define ATTR_GAME_STATE __attribute__((section("game_state")))
+#endif
+
 #endif
 
 #ifndef __dead2
@@ -14,6 +14,11 @@ bool SDLApp_PollEvents();
 
 void SDLApp_BeginFrame();
 void SDLApp_EndFrame();
+
+/// @brief Stretch (`scale` > 1) or shrink (`scale` < 1) the time of the following frames.
+///
+/// Netplay uses this to drift towards the clock of the remote peer without skipping frames.
+void SDLApp_SetFrameTimeScale(double scale);
 void SDLApp_Exit();
 
 #endif
@@ -33,15 +33,65 @@ typedef struct Sprite2 {
     unsigned int id;
 } Sprite2;
 
+typedef enum SDLGameRenderer_Backend {
+    SDL_GAME_RENDERER_BACKEND_GPU, // Draws into `cps3_canvas` with the SDL renderer
+    SDL_GAME_RENDERER_BACKEND_CPU, // Rasterizes on the render worker, then uploads the result to `cps3_canvas`
+} SDLGameRenderer_Backend;
+
+typedef struct SDLGameRenderer_TextureCacheStats {
+    int textures;
+    size_t bytes;
+    size_t budget; // 0 for no limit
+
+    // Since the start of the current frame
+    int hits;
+    int misses;
+    int evictions;
+} SDLGameRenderer_TextureCacheStats;
+
 extern SDL_Texture* cps3_canvas;
 
-void SDLGameRenderer_Init(SDL_Renderer* renderer);
+/// @param renderer Renderer that owns `cps3_canvas`. May be `NULL` with the CPU backend,
+/// in which case frames are only available through `SDLGameRenderer_GetSoftwareCanvas`.
+void SDLGameRenderer_Init(SDL_Renderer* renderer, SDLGameRenderer_Backend backend);
+void SDLGameRenderer_Quit();
 void SDLGameRenderer_BeginFrame();
+
+/// Hand the quads drawn since `SDLGameRenderer_BeginFrame` to the render worker,
+/// which sorts and batches them while the caller does something else.
+void SDLGameRenderer_SubmitFrame();
+
+/// Draw the submitted frame to `cps3_canvas`, waiting for the worker if it isn't done yet.
+/// Does nothing if no frame was submitted.
 void SDLGameRenderer_RenderFrame();
+
+/// Release the frame drawn by `SDLGameRenderer_RenderFrame`.
 void SDLGameRenderer_EndFrame();
 
+/// @return Number of geometry submissions made by the last `SDLGameRenderer_RenderFrame` call.
+int SDLGameRenderer_GetDrawCallCount();
+
+/// @return The last frame drawn by the CPU backend (384x224 ARGB8888), `NULL` with the GPU backend.
+const SDL_Surface* SDLGameRenderer_GetSoftwareCanvas();
+
+/// @return Number of quads in the last submitted frame.
+int SDLGameRenderer_GetRenderTaskCount();
+
+/// @return Most quads any frame has had since startup.
+int SDLGameRenderer_GetRenderTaskHighWater();
+
+/// Limit how much memory cached textures take up. Least recently used ones are destroyed
+/// to stay under `bytes`, except for the ones drawn in the current frame.
+/// @param bytes Budget, 0 for no limit.
+void SDLGameRenderer_SetTextureCacheBudget(size_t bytes);
+const SDLGameRenderer_TextureCacheStats* SDLGameRenderer_GetTextureCacheStats();
+
 void SDLGameRenderer_CreateTexture(unsigned int th);
 void SDLGameRenderer_DestroyTexture(unsigned int texture_handle);
+
+/// Note that `rect` of a texture is about to be rewritten. The next unlock
+/// only uploads the marked parts, or the whole texture if nothing was marked.
+void SDLGameRenderer_MarkTextureDirty(unsigned int th, const SDL_Rect* rect);
 void SDLGameRenderer_UnlockTexture(unsigned int th);
 void SDLGameRenderer_CreatePalette(unsigned int ph);
 void SDLGameRenderer_DestroyPalette(unsigned int palette_handle);
@@ -0,0 +1,15 @@
+#ifndef SDL_SOFT_RASTERIZER_H
+#define SDL_SOFT_RASTERIZER_H
+
+#include <SDL3/SDL.h>
+
+/// Fill `canvas` with `argb`. Both `canvas` and textures are `SDL_PIXELFORMAT_ARGB8888`.
+void SoftRasterizer_Clear(SDL_Surface* canvas, Uint32 argb);
+
+/// Draw a quad made of the triangles 0-1-2 and 1-2-3, the way `SDL_RenderGeometry` draws it
+/// with nearest sampling and `SDL_BLENDMODE_BLEND`: pixels whose centers are inside are covered
+/// (top-left rule on shared edges), texels are multiplied by the vertex color and blended over `canvas`.
+/// @param texture Texture to sample, `NULL` for a solid quad.
+void SoftRasterizer_DrawQuad(SDL_Surface* canvas, const SDL_Surface* texture, const SDL_Vertex* vertices);
+
+#endif
@@ -3,6 +3,13 @@
 
 #include "types.h"
 
+/// Decode exactly `size` bytes. Only writes are checked, the stream is trusted otherwise.
+/// @return 1 on success, 0 if the stream decodes to more or less than `size` bytes.
 s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size);
 
+/// Decode exactly `dstSize` bytes from a stream that may be damaged.
+/// @return 1 on success, 0 if the stream reads past `srcSize` bytes, refers to data before `dst`,
+/// or doesn't decode to exactly `dstSize` bytes. Nothing is read or written out of bounds either way.
+s32 decLZ77withBoundsCheck(const u8* src, s32 srcSize, u8* dst, s32 dstSize);
+
 #endif
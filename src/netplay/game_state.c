@@ -1,1321 +1,202 @@
 #include "netplay/game_state.h"
-#include "sf33rd/Source/Game/animation/appear.h"
-#include "sf33rd/Source/Game/animation/win_pl.h"
-#include "sf33rd/Source/Game/effect/eff56.h"
-#include "sf33rd/Source/Game/effect/effb2.h"
-#include "sf33rd/Source/Game/effect/effb8.h"
-#include "sf33rd/Source/Game/engine/charset.h"
-#include "sf33rd/Source/Game/engine/plcnt.h"
-#include "sf33rd/Source/Game/engine/slowf.h"
-#include "sf33rd/Source/Game/engine/spgauge.h"
-#include "sf33rd/Source/Game/engine/workuser.h"
-#include "sf33rd/Source/Game/select_timer.h"
-#include "sf33rd/Source/Game/stage/bg_data.h"
-#include "sf33rd/Source/Game/stage/ta_sub.h"
-#include "sf33rd/Source/Game/system/work_sys.h"
-#include "sf33rd/Source/Game/ui/count.h"
-#include "sf33rd/Source/Game/ui/sc_sub.h"
+#include "common.h"
 
 #include <SDL3/SDL.h>
 
-#define GS_SAVE(member) SDL_memcpy(&dst->member, &member, sizeof(member))
-
-void GameState_Save(GameState* dst) {
-    GS_SAVE(Scene_Cut);
-    GS_SAVE(Time_Over);
-    GS_SAVE(round_timer);
-    GS_SAVE(flash_timer);
-    GS_SAVE(flash_r_num);
-    GS_SAVE(flash_col);
-    GS_SAVE(math_counter_hi);
-    GS_SAVE(math_counter_low);
-    GS_SAVE(counter_color);
-    GS_SAVE(mugen_flag);
-    GS_SAVE(hoji_counter);
-    GS_SAVE(select_timer_state);
-    GS_SAVE(Order);
-    GS_SAVE(Order_Timer);
-    GS_SAVE(Order_Dir);
-    GS_SAVE(Score);
-    GS_SAVE(Complete_Bonus);
-    GS_SAVE(Stock_Score);
-    GS_SAVE(Vital_Bonus);
-    GS_SAVE(Time_Bonus);
-    GS_SAVE(Stage_Stock_Score);
-    GS_SAVE(Bonus_Score);
-    GS_SAVE(Final_Bonus_Score);
-    GS_SAVE(WGJ_Score);
-    GS_SAVE(Bonus_Score_Plus);
-    GS_SAVE(Perfect_Bonus);
-    GS_SAVE(Keep_Score);
-    GS_SAVE(Disp_Score_Buff);
-    GS_SAVE(Winner_id);
-    GS_SAVE(Loser_id);
-    GS_SAVE(Break_Into);
-    GS_SAVE(My_char);
-    GS_SAVE(Allow_a_battle_f);
-    GS_SAVE(Round_num);
-    GS_SAVE(Complete_Judgement);
-    GS_SAVE(Fade_Flag);
-    GS_SAVE(Super_Arts);
-    GS_SAVE(Forbid_Break);
-    GS_SAVE(Request_Break);
-    GS_SAVE(Continue_Count);
-    GS_SAVE(Counter_hi);
-    GS_SAVE(Counter_low);
-    GS_SAVE(Unit_Of_Timer);
-    GS_SAVE(Select_Timer);
-    GS_SAVE(Cursor_X);
-    GS_SAVE(Cursor_Y);
-    GS_SAVE(Cursor_Y_Pos);
-    GS_SAVE(Cursor_Timer);
-    GS_SAVE(Time_Stop);
-    GS_SAVE(Suicide);
-    GS_SAVE(Complete_Face);
-    GS_SAVE(Play_Type);
-    GS_SAVE(Sel_PL_Complete);
-    GS_SAVE(New_Challenger);
-    GS_SAVE(S_No);
-    GS_SAVE(Select_Start);
-    GS_SAVE(request_message);
-    GS_SAVE(judge_flag);
-    GS_SAVE(WINNER);
-    GS_SAVE(LOSER);
-    GS_SAVE(Champion);
-    GS_SAVE(Fade_Half_Flag);
-    GS_SAVE(Reserve_Cut);
-    GS_SAVE(Perfect_Flag);
-    GS_SAVE(Next_Step);
-    GS_SAVE(Switch_Type);
-    GS_SAVE(Cover_Timer);
-    GS_SAVE(Personal_Timer);
-    GS_SAVE(Request_E_No);
-    GS_SAVE(Request_G_No);
-    GS_SAVE(Present_Rank);
-    GS_SAVE(Best_Grade);
-    GS_SAVE(Demo_Type);
-    GS_SAVE(Rank_Type);
-    GS_SAVE(Flash_Sign);
-    GS_SAVE(Flash_Rank_Time);
-    GS_SAVE(Flash_Rank_Interval);
-    GS_SAVE(Ranking_X);
-    GS_SAVE(Rank);
-    GS_SAVE(Rank_X);
-    GS_SAVE(E_07_Flag);
-    GS_SAVE(Complete_Victory);
-    GS_SAVE(Demo_Flag);
-    GS_SAVE(Next_Demo);
-    GS_SAVE(Demo_PL_Index);
-    GS_SAVE(Demo_Stage_Index);
-    GS_SAVE(Face_MV_Request);
-    GS_SAVE(Face_Move);
-    GS_SAVE(Player_id);
-    GS_SAVE(Last_Player_id);
-    GS_SAVE(Player_Number);
-    GS_SAVE(DENJIN_Term);
-    GS_SAVE(Rapid_No);
-    GS_SAVE(COM_id);
-    GS_SAVE(EM_id);
-    GS_SAVE(Select_Status);
-    GS_SAVE(Select_Demo_Index);
-    GS_SAVE(Country);
-    GS_SAVE(Demo_Time_Stop);
-    GS_SAVE(Combo_Speed);
-    GS_SAVE(Exec_Wipe);
-    GS_SAVE(Passive_Mode);
-    GS_SAVE(Passive_Flag);
-    GS_SAVE(Flip_Flag);
-    GS_SAVE(Lie_Flag);
-    GS_SAVE(Counter_Attack);
-    GS_SAVE(Attack_Flag);
-    GS_SAVE(Limited_Flag);
-    GS_SAVE(Shell_Ignore_Timer);
-    GS_SAVE(Event_Judge_Gals);
-    GS_SAVE(EJG_index);
-    GS_SAVE(Guard_Flag);
-    GS_SAVE(Pierce_Menu);
-    GS_SAVE(Face_MV_Time);
-    GS_SAVE(Before_Jump);
-    GS_SAVE(Stop_Combo);
-    GS_SAVE(Stock_Hit_Flag);
-    GS_SAVE(Rolling_Flag);
-    GS_SAVE(Continue_Coin);
-    GS_SAVE(Ignore_Entry);
-    GS_SAVE(Slide_Type);
-    GS_SAVE(Moving_Plate);
-    GS_SAVE(Naming_Cut);
-    GS_SAVE(Moving_Plate_Counter);
-    GS_SAVE(Player_Color);
-    GS_SAVE(PP_Priority);
-    GS_SAVE(OK_Priority);
-    GS_SAVE(Stock_My_char);
-    GS_SAVE(Stock_Player_Color);
-    GS_SAVE(Music_Fade);
-    GS_SAVE(Stop_SG);
-    GS_SAVE(Operator_Status);
-    GS_SAVE(Round_Operator);
-    GS_SAVE(another_bg);
-    GS_SAVE(Last_Super_Arts);
-    GS_SAVE(Last_My_char);
-    GS_SAVE(Continue_Menu);
-    GS_SAVE(Timer_Freeze);
-    GS_SAVE(Type_of_Attack);
-    GS_SAVE(Standing_Timer);
-    GS_SAVE(Before_Look);
-    GS_SAVE(Attack_Count_No0);
-    GS_SAVE(Standing_Master_Timer);
-    GS_SAVE(PB_Music_Off);
-    GS_SAVE(No_Death);
-    GS_SAVE(Flash_MT);
-    GS_SAVE(Squat_Timer);
-    GS_SAVE(Squat_Master_Timer);
-    GS_SAVE(Turn_Over);
-    GS_SAVE(Turn_Over_Timer);
-    GS_SAVE(Jump_Pass_Timer);
-    GS_SAVE(sa_gauge_flash);
-    GS_SAVE(Receive_Flag);
-    GS_SAVE(Disposal_Again);
-    GS_SAVE(BGM_Vol);
-    GS_SAVE(Used_char);
-    GS_SAVE(Break_Com);
-    GS_SAVE(aiuchi_flag);
-    GS_SAVE(paring_counter);
-    GS_SAVE(paring_bonus_r);
-    GS_SAVE(paring_ctr_vs);
-    GS_SAVE(paring_ctr_ori);
-    GS_SAVE(Attack_Count_Buff);
-    GS_SAVE(Attack_Count_Index);
-    GS_SAVE(CC_Value);
-    GS_SAVE(Continue_Coin2);
-    GS_SAVE(Weak_PL);
-    GS_SAVE(Bullet_No);
-    GS_SAVE(Bullet_Counter);
-    GS_SAVE(Final_Result_id);
-    GS_SAVE(Disp_Win_Name);
-    GS_SAVE(Perfect_Counter);
-    GS_SAVE(Straight_Counter);
-    GS_SAVE(Appear_Q);
-    GS_SAVE(Cut_Scroll);
-    GS_SAVE(Break_Into_CPU);
-    GS_SAVE(ID_of_Face);
-    GS_SAVE(Cursor_Move);
-    GS_SAVE(Auto_Cursor);
-    GS_SAVE(Auto_No);
-    GS_SAVE(Auto_Index);
-    GS_SAVE(Auto_Timer);
-    GS_SAVE(Explosion);
-    GS_SAVE(Introduce_Break_Into);
-    GS_SAVE(gouki_wins);
-    GS_SAVE(EM_Rank);
-    GS_SAVE(Disp_PERFECT);
-    GS_SAVE(Escape_SS);
-    GS_SAVE(Deley_Shot_No);
-    GS_SAVE(Deley_Shot_Timer);
-    GS_SAVE(Lost_Round);
-    GS_SAVE(Super_Arts_Finish);
-    GS_SAVE(Stage_SA_Finish);
-    GS_SAVE(Perfect_Finish);
-    GS_SAVE(Cheap_Finish);
-    GS_SAVE(Last_My_char2);
-    GS_SAVE(gouki_app);
-    GS_SAVE(Bonus_Game_Complete);
-    GS_SAVE(Get_Demo_Index);
-    GS_SAVE(Combo_Demo_Flag);
-    GS_SAVE(Stage_Continue);
-    GS_SAVE(Pause_Hit_Marks);
-    GS_SAVE(Extra_Break);
-    GS_SAVE(Shin_Gouki_BGM);
-    GS_SAVE(Stage_Lost_Round);
-    GS_SAVE(Stage_Perfect_Finish);
-    GS_SAVE(Stage_Cheap_Finish);
-    GS_SAVE(EXE_obroll);
-    GS_SAVE(End_PL);
-    GS_SAVE(Stock_Com_Arts);
-    GS_SAVE(PB_Status);
-    GS_SAVE(Flip_Counter);
-    GS_SAVE(Stage_Time_Finish);
-    GS_SAVE(Bonus_Type);
-    GS_SAVE(Completion_Bonus);
-    GS_SAVE(ichikannkei);
-    GS_SAVE(Plate_Disposal_No);
-    GS_SAVE(SO_No);
-    GS_SAVE(Disp_Command_Name);
-    GS_SAVE(SC_No);
-    GS_SAVE(BGM_No);
-    GS_SAVE(BGM_Timer);
-    GS_SAVE(EM_List);
-    GS_SAVE(Sel_EM_Complete);
-    GS_SAVE(Temporary_EM);
-    GS_SAVE(OK_Moving_SA_Plate);
-    GS_SAVE(Battle_Q);
-    GS_SAVE(EM_History);
-    GS_SAVE(GO_No);
-    GS_SAVE(Aborigine);
-    GS_SAVE(Continue_Count_Down);
-    GS_SAVE(WGJ_Target);
-    GS_SAVE(EM_Candidate);
-    GS_SAVE(Last_Selected_EM);
-    GS_SAVE(Q_Country);
-    GS_SAVE(Continue_Cut);
-    GS_SAVE(Introduce_Boss);
-    GS_SAVE(Final_Play_Type);
-    GS_SAVE(Rank_In);
-    GS_SAVE(Request_Disp_Rank);
-    GS_SAVE(Reset_Timer);
-    GS_SAVE(bbbs_type);
-    GS_SAVE(Straight_Flag);
-    GS_SAVE(kakushi_ix);
-    GS_SAVE(kakushi_op);
-    GS_SAVE(RO_backup);
-    GS_SAVE(PT_backup);
-    GS_SAVE(E_Number);
-    GS_SAVE(E_No);
-    GS_SAVE(C_No);
-    GS_SAVE(G_No);
-    GS_SAVE(D_No);
-    GS_SAVE(M_No);
-    GS_SAVE(Exit_No);
-    GS_SAVE(SP_No);
-    GS_SAVE(Face_No);
-    GS_SAVE(Stop_Cursor);
-    GS_SAVE(Training_Index);
-    GS_SAVE(Connect_Status);
-    GS_SAVE(Menu_Suicide);
-    GS_SAVE(Game_pause);
-    GS_SAVE(Game_difficulty);
-    GS_SAVE(Pause);
-    GS_SAVE(Pause_ID);
-    GS_SAVE(Exit_Menu);
-    GS_SAVE(Conclusion_Flag);
-    GS_SAVE(CP_No);
-    GS_SAVE(CP_Index);
-    GS_SAVE(Gap_Timer);
-    GS_SAVE(Message_Suicide);
-    GS_SAVE(Disp_Cockpit);
-    GS_SAVE(Select_Arts);
-    GS_SAVE(Lamp_No);
-    GS_SAVE(Lamp_Index);
-    GS_SAVE(Lamp_Color);
-    GS_SAVE(Stop_Update_Score);
-    GS_SAVE(test_flag);
-    GS_SAVE(ixbfw_cut);
-    GS_SAVE(Cont_No);
-    GS_SAVE(PL_Wins);
-    GS_SAVE(Fade_R_No0);
-    GS_SAVE(Fade_R_No1);
-    GS_SAVE(Conclusion_Type);
-    GS_SAVE(win_type);
-    GS_SAVE(message_index);
-    GS_SAVE(F_No0);
-    GS_SAVE(F_No1);
-    GS_SAVE(F_No2);
-    GS_SAVE(F_No3);
-    GS_SAVE(keep_condition);
-    GS_SAVE(Check_Buff);
-    GS_SAVE(Convert_Buff);
-    GS_SAVE(Unsubstantial_BG);
-    GS_SAVE(Menu_Cursor_X);
-    GS_SAVE(Menu_Cursor_Y);
-    GS_SAVE(Replay_Status);
-    GS_SAVE(Disappear_LOGO);
-    GS_SAVE(count_end);
-    GS_SAVE(Play_Game);
-    GS_SAVE(Menu_Cursor_Move);
-    GS_SAVE(flash_win_type);
-    GS_SAVE(sync_win_type);
-    GS_SAVE(Mode_Type);
-    GS_SAVE(Menu_Page);
-    GS_SAVE(Menu_Max);
-    GS_SAVE(reset_NG_flag);
-    GS_SAVE(VS_Stage);
-    GS_SAVE(Present_Mode);
-    GS_SAVE(Play_Mode);
-    GS_SAVE(Page_Max);
-    GS_SAVE(Direction_Working);
-    GS_SAVE(Vital_Handicap);
-    GS_SAVE(Cursor_Limit);
-    GS_SAVE(Synchro_No);
-    GS_SAVE(SA_shadow_on);
-    GS_SAVE(Pause_Down);
-    GS_SAVE(Training_ID);
-    GS_SAVE(Disp_Attack_Data);
-    GS_SAVE(Record_Data_Tr);
-    GS_SAVE(End_Training);
-    GS_SAVE(Menu_Page_Buff);
-    GS_SAVE(Reset_Bootrom);
-    GS_SAVE(Decide_ID);
-    GS_SAVE(Training_Cursor);
-    GS_SAVE(Lag_Timer);
-    GS_SAVE(CPU_Time_Lag);
-    GS_SAVE(Forbid_Reset);
-    GS_SAVE(CPU_Rec);
-    GS_SAVE(Pause_Type);
-    GS_SAVE(Game_timer);
-    GS_SAVE(Control_Time);
-    GS_SAVE(Time_in_Time);
-    GS_SAVE(Round_Level);
-    GS_SAVE(Round_Result);
-    GS_SAVE(Fade_Number);
-    GS_SAVE(G_Timer);
-    GS_SAVE(D_Timer);
-    GS_SAVE(Rank_Pos_X);
-    GS_SAVE(Rank_Pos_Y);
-    GS_SAVE(E_Timer);
-    GS_SAVE(F_Timer);
-    GS_SAVE(ENTRY_X);
-    GS_SAVE(C_Timer);
-    GS_SAVE(S_Timer);
-    GS_SAVE(Flash_Complete);
-    GS_SAVE(Sel_Arts_Complete);
-    GS_SAVE(Arts_Y);
-    GS_SAVE(Move_Super_Arts);
-    GS_SAVE(Battle_Country);
-    GS_SAVE(Face_Status);
-    GS_SAVE(ID);
-    GS_SAVE(ID2);
-    GS_SAVE(mes_already);
-    GS_SAVE(Timer_00);
-    GS_SAVE(Timer_01);
-    GS_SAVE(PL_Distance);
-    GS_SAVE(Area_Number);
-    GS_SAVE(Lever_Buff);
-    GS_SAVE(Lever_Pool);
-    GS_SAVE(Tech_Index);
-    GS_SAVE(Random_ix16);
-    GS_SAVE(Random_ix32);
-    GS_SAVE(M_Timer);
-    GS_SAVE(VS_Tech);
-    GS_SAVE(Guard_Type);
-    GS_SAVE(Separate_Area);
-    GS_SAVE(Free_Lever);
-    GS_SAVE(Term_No);
-    GS_SAVE(Com_Width_Data);
-    GS_SAVE(Lever_Squat);
-    GS_SAVE(M_Lv);
-    GS_SAVE(Insert_Y);
-    GS_SAVE(scr_req_x);
-    GS_SAVE(scr_req_y);
-    GS_SAVE(zoom_req_flag_old);
-    GS_SAVE(zoom_request_flag);
-    GS_SAVE(zoom_request_level);
-    GS_SAVE(Last_Selected_ID);
-    GS_SAVE(Last_Called_SE);
-    GS_SAVE(VS_Index);
-    GS_SAVE(Rapid_Index);
-    GS_SAVE(Shell_Separate_Area);
-    GS_SAVE(Attack_Counter);
-    GS_SAVE(Last_Attack_Counter);
-    GS_SAVE(Pattern_Index);
-    GS_SAVE(Com_Color_Shot);
-    GS_SAVE(Resume_Lever);
-    GS_SAVE(players_timer);
-    GS_SAVE(Lever_Store);
-    GS_SAVE(Return_CP_No);
-    GS_SAVE(Return_CP_Index);
-    GS_SAVE(Return_Pattern_Index);
-    GS_SAVE(Lever_LR);
-    GS_SAVE(Last_Eftype);
-    GS_SAVE(DENJIN_No);
-    GS_SAVE(SC_Personal_Time);
-    GS_SAVE(Guard_Counter);
-    GS_SAVE(Limit_Time);
-    GS_SAVE(Last_Pattern_Index);
-    GS_SAVE(Random_ix16_ex);
-    GS_SAVE(Random_ix32_ex);
-    GS_SAVE(DE_X);
-    GS_SAVE(Exit_Timer);
-    GS_SAVE(Max_vitality);
-    GS_SAVE(Bonus_Game_Flag);
-    GS_SAVE(Bonus_Game_Work);
-    GS_SAVE(Bonus_Game_result);
-    GS_SAVE(Stock_Bonus_Game_Result);
-    GS_SAVE(bs_scrrrl);
-    GS_SAVE(Bonus_Stage_RNO);
-    GS_SAVE(Bonus_Stage_Level);
-    GS_SAVE(Bonus_Stage_Tix);
-    GS_SAVE(Bonus_Game_ex_result);
-    GS_SAVE(Stock_Com_Color);
-    GS_SAVE(bs2_floor);
-    GS_SAVE(bs2_hosei);
-    GS_SAVE(bs2_current_damage);
-    GS_SAVE(Win_Record);
-    GS_SAVE(Stock_Win_Record);
-    GS_SAVE(WGJ_Win);
-    GS_SAVE(Target_BG_X);
-    GS_SAVE(Offset_BG_X);
-    GS_SAVE(Result_Timer);
-    GS_SAVE(scrl);
-    GS_SAVE(scrr);
-    GS_SAVE(vital_stop_flag);
-    GS_SAVE(gauge_stop_flag);
-    GS_SAVE(Lamp_Timer);
-    GS_SAVE(Cont_Timer);
-    GS_SAVE(Plate_X);
-    GS_SAVE(Plate_Y);
-    // GS_SAVE(Demo_Timer);
-    // GS_SAVE(Condense_Buff);
-    GS_SAVE(Keep_Grade);
-    GS_SAVE(IO_Result);
-    GS_SAVE(VS_Win_Record);
-    GS_SAVE(PLsw);
-    GS_SAVE(plsw_00);
-    GS_SAVE(plsw_01);
-    GS_SAVE(Flash_Synchro);
-    GS_SAVE(Synchro_Level);
-    GS_SAVE(Random_ix16_com);
-    GS_SAVE(Random_ix32_com);
-    GS_SAVE(Random_ix16_ex_com);
-    GS_SAVE(Random_ix32_ex_com);
-    GS_SAVE(Random_ix16_bg);
-    GS_SAVE(Opening_Now);
-    GS_SAVE(task);
-
-    // plcnt
-
-    GS_SAVE(plw);
-    GS_SAVE(zanzou_table);
-    GS_SAVE(super_arts);
-    GS_SAVE(piyori_type);
-    GS_SAVE(appear_type);
-    GS_SAVE(pcon_rno);
-    GS_SAVE(round_slow_flag);
-    GS_SAVE(pcon_dp_flag);
-    GS_SAVE(win_sp_flag);
-    GS_SAVE(dead_voice_flag);
-    GS_SAVE(rambod);
-    GS_SAVE(ramhan);
-    GS_SAVE(vital_inc_timer);
-    GS_SAVE(vital_dec_timer);
-    GS_SAVE(sag_inc_timer);
-
-    // cmd_data
-
-    GS_SAVE(wcp);
-    GS_SAVE(t_pl_lvr);
-    GS_SAVE(waza_work);
-
-    // cmb_win
-
-    GS_SAVE(cmst_buff);
-    GS_SAVE(old_cmb_flag);
-    GS_SAVE(cmb_stock);
-    GS_SAVE(first_attack);
-    GS_SAVE(rever_attack);
-    GS_SAVE(paring_attack);
-    GS_SAVE(bonus_pts);
-    GS_SAVE(hit_num);
-    GS_SAVE(sa_kind);
-    GS_SAVE(end_flag);
-    GS_SAVE(calc_hit);
-    GS_SAVE(score_calc);
-    GS_SAVE(cmb_all_stock);
-    GS_SAVE(sarts_finish_flag);
-    GS_SAVE(last_hit_time);
-    GS_SAVE(cmb_calc_now);
-    GS_SAVE(cst_read);
-    GS_SAVE(cst_write);
-
-    // bg
-
-    GS_SAVE(bg_w);
+// Uncomment to log bulk vs. per-variable snapshot cost
+// #define GAME_STATE_BENCHMARK
+
+// Bounds of the arena, provided by the linker
+#if defined(__APPLE__)
+extern u8 game_state_begin[] __asm("section$start$__DATA$__game_state");
+extern u8 game_state_end[] __asm("section$end$__DATA$__game_state");
+#elif defined(_WIN32)
+// ld sorts .data$* input sections by name, so these bracket .data$game_state_b
+__attribute__((section(".data$game_state_a"))) ATTR_ALIGNED(64) static u8 game_state_begin[0];
+__attribute__((section(".data$game_state_c"))) static u8 game_state_end[0];
+#else
+extern u8 __start_game_state[];
+extern u8 __stop_game_state[];
+#define game_state_begin __start_game_state
+#define game_state_end __stop_game_state
+#endif
+
+#if !defined(_WIN32)
+// The section is as aligned as its most aligned member, which keeps the arena cache-aligned
+ATTR_GAME_STATE ATTR_ALIGNED(64) __attribute__((used)) static u8 game_state_anchor;
+#endif
+
+#define GS_CHECK_MEMBER(member)                                                                                        \
+    if (((u8*)&member < game_state_begin) || ((u8*)&member + sizeof(member) > game_state_end)) {                      \
+        fatal_error("%s is not in the game state arena", #member);                                                     \
+    }
+
+typedef struct ArenaMember {
+    const u8* begin;
+    size_t size;
+    size_t align;
+    const char* name;
+} ArenaMember;
+
+#define GS_LIST_MEMBER(member) { (const u8*)&member, sizeof(member), __alignof__(member), #member },
+
+static const ArenaMember arena_members[] = {
+    GAME_STATE_MEMBERS(GS_LIST_MEMBER)
+#if !defined(_WIN32)
+    { &game_state_anchor, sizeof(game_state_anchor), 64, "game_state_anchor" },
+#endif
+};
+
+static int compare_members(const void* a, const void* b) {
+    const u8* a_begin = ((const ArenaMember*)a)->begin;
+    const u8* b_begin = ((const ArenaMember*)b)->begin;
+    return (a_begin > b_begin) - (a_begin < b_begin);
+}
 
-    // charset
+/// Padding before a member is shorter than its alignment, or than the alignment of the section
+/// of its object file if it's the first member there. Either way, its address is aligned to it.
+static size_t padding_limit(const u8* address, size_t align_max) {
+    size_t align = align_max;
 
-    GS_SAVE(att_req);
+    while (((uintptr_t)address % align) != 0) {
+        align /= 2;
+    }
 
-    // slowf
+    return align;
+}
 
-    GS_SAVE(SLOW_timer);
-    GS_SAVE(SLOW_flag);
-    GS_SAVE(EXE_flag);
+/// Fail if the arena holds anything besides the listed members and the padding between them,
+/// which means that a global was given `ATTR_GAME_STATE` without being added to `GAME_STATE_MEMBERS`.
+static void check_unlisted() {
+    ArenaMember members[SDL_arraysize(arena_members)];
+    const u8* cursor = game_state_begin;
+    const char* previous = "the start";
+    size_t align_max = 1;
 
-    // grade
+    SDL_memcpy(members, arena_members, sizeof(members));
+    SDL_qsort(members, SDL_arraysize(members), sizeof(ArenaMember), compare_members);
 
-    GS_SAVE(judge_gals);
-    GS_SAVE(judge_com);
-    GS_SAVE(last_judge_dada);
-    GS_SAVE(judge_final);
-    GS_SAVE(judge_item);
-    GS_SAVE(ji_sat);
+    for (int i = 0; i < SDL_arraysize(members); i++) {
+        align_max = SDL_max(align_max, members[i].align);
+    }
 
-    // spgauge
+    for (int i = 0; i < SDL_arraysize(members); i++) {
+        const ArenaMember* member = &members[i];
 
-    GS_SAVE(Old_Stop_SG);
-    GS_SAVE(Exec_Wipe_F);
-    GS_SAVE(time_clear);
-    GS_SAVE(spg_number);
-    GS_SAVE(spg_work);
-    GS_SAVE(spg_offset);
-    GS_SAVE(time_num);
-    GS_SAVE(time_timer);
-    GS_SAVE(time_flag);
-    GS_SAVE(col);
-    GS_SAVE(time_operate);
-    GS_SAVE(sast_now);
-    GS_SAVE(max2);
-    GS_SAVE(max_rno2);
-    GS_SAVE(spg_dat);
+        if ((member->begin > cursor) && ((size_t)(member->begin - cursor) >= padding_limit(member->begin, align_max))) {
+            fatal_error("Game state arena has unlisted data between %s and %s", previous, member->name);
+        }
 
-    // stun
+        cursor = SDL_max(cursor, member->begin + member->size);
+        previous = member->name;
+    }
 
-    GS_SAVE(sdat);
+    if ((game_state_end > cursor) && ((size_t)(game_state_end - cursor) >= align_max)) {
+        fatal_error("Game state arena has unlisted data after %s", previous);
+    }
+}
 
-    // vital
+static void check_arena() {
+    static bool checked = false;
 
-    GS_SAVE(vit);
+    if (checked) {
+        return;
+    }
 
-    // win_pl
+    if (GameState_Size() > sizeof(((GameState*)NULL)->data)) {
+        fatal_error("Game state arena is larger than GameState");
+    }
 
-    GS_SAVE(win_free);
-    GS_SAVE(win_rno);
-    GS_SAVE(poison_flag);
+    GAME_STATE_MEMBERS(GS_CHECK_MEMBER)
+    check_unlisted();
+    checked = true;
+}
 
-    // ta_sub
+#if defined(GAME_STATE_BENCHMARK)
+#define GAME_STATE_BENCHMARK_INTERVAL 600
 
-    GS_SAVE(eff_hit_flag);
+typedef struct GameStateBenchmark {
+    Uint64 count;
+    Uint64 bulk_save_ns;
+    Uint64 bulk_load_ns;
+    Uint64 member_save_ns;
+    Uint64 member_load_ns;
+} GameStateBenchmark;
 
-    // sc_sub
+static GameStateBenchmark benchmark = { 0 };
 
-    GS_SAVE(FadeLimit);
-    GS_SAVE(WipeLimit);
+#define GS_SAVE(member) SDL_memcpy(&GS_MEMBER(dst, member), &member, sizeof(member));
+#define GS_LOAD(member) SDL_memcpy(&member, &GS_MEMBER(src, member), sizeof(member));
 
-    // appear
+/// Snapshot the same globals one memcpy at a time, the way it was done before the arena.
+static void save_members(GameState* dst) {
+    GAME_STATE_MEMBERS(GS_SAVE)
+}
 
-    GS_SAVE(Appear_car_stop);
-    GS_SAVE(Appear_hv);
-    GS_SAVE(Appear_free);
-    GS_SAVE(Appear_flag);
-    GS_SAVE(app_counter);
-    GS_SAVE(appear_work);
-    GS_SAVE(Appear_end);
+static void load_members(const GameState* src) {
+    GAME_STATE_MEMBERS(GS_LOAD)
+}
 
-    // bg_data
+static void report_benchmark() {
+    const double count = (double)benchmark.count;
 
-    GS_SAVE(y_sitei_pos);
-    GS_SAVE(y_sitei_flag);
-    GS_SAVE(c_number);
-    GS_SAVE(c_kakikae);
-    GS_SAVE(g_number);
-    GS_SAVE(g_kakikae);
-    GS_SAVE(nosekae);
-    GS_SAVE(scrn_adgjust_y);
-    GS_SAVE(scrn_adgjust_x);
-    GS_SAVE(zoom_add);
-    GS_SAVE(ls_cnt1);
-    GS_SAVE(bg_app);
-    GS_SAVE(sa_pa_flag);
-    GS_SAVE(aku_flag);
-    GS_SAVE(seraph_flag);
-    GS_SAVE(akebono_flag);
-    GS_SAVE(bg_mvxy);
-    GS_SAVE(chase_time_y);
-    GS_SAVE(chase_time_x);
-    GS_SAVE(chase_y);
-    GS_SAVE(chase_x);
-    GS_SAVE(demo_car_flag);
-    GS_SAVE(ideal_w);
-    GS_SAVE(bg_app_stop);
-    GS_SAVE(bg_stop);
-    GS_SAVE(base_y_pos);
-    GS_SAVE(etcBgPalCnvTable);
-    GS_SAVE(etcBgGixCnvTable);
+    SDL_Log("[game state] %zu B | bulk: save %.0f ns, load %.0f ns | per member: save %.0f ns, load %.0f ns",
+            GameState_Size(),
+            benchmark.bulk_save_ns / count,
+            benchmark.bulk_load_ns / count,
+            benchmark.member_save_ns / count,
+            benchmark.member_load_ns / count);
 
-    // eff56
+    SDL_zero(benchmark);
+}
 
-    GS_SAVE(ci_pointer);
-    GS_SAVE(ci_col);
-    GS_SAVE(ci_timer);
+/// Time both snapshot paths against the current state. Leaves the live globals unchanged.
+static void run_benchmark() {
+    static GameState scratch;
+    Uint64 start;
 
-    // effb2
+    start = SDL_GetTicksNS();
+    save_members(&scratch);
+    benchmark.member_save_ns += SDL_GetTicksNS() - start;
 
-    GS_SAVE(rf_b2_flag);
-    GS_SAVE(b2_curr_no);
+    start = SDL_GetTicksNS();
+    load_members(&scratch);
+    benchmark.member_load_ns += SDL_GetTicksNS() - start;
 
-    // effb8
+    start = SDL_GetTicksNS();
+    SDL_memcpy(scratch.data, game_state_begin, GameState_Size());
+    benchmark.bulk_save_ns += SDL_GetTicksNS() - start;
 
-    GS_SAVE(test_pl_no);
-    GS_SAVE(test_mes_no);
-    GS_SAVE(test_in);
-    GS_SAVE(old_mes_no2);
-    GS_SAVE(old_mes_no3);
-    GS_SAVE(old_mes_no_pl);
-    GS_SAVE(mes_timer);
+    start = SDL_GetTicksNS();
+    SDL_memcpy(game_state_begin, scratch.data, GameState_Size());
+    benchmark.bulk_load_ns += SDL_GetTicksNS() - start;
 
-    // work_sys — rollback-critical state
+    benchmark.count += 1;
 
-    GS_SAVE(bg_pos);
-    GS_SAVE(fm_pos);
-    GS_SAVE(bg_prm);
-    GS_SAVE(system_timer);
-    GS_SAVE(Gill_Appear_Flag);
+    if (benchmark.count >= GAME_STATE_BENCHMARK_INTERVAL) {
+        report_benchmark();
+    }
+}
+#endif
 
-    // plcnt — DIP switch combat config
+size_t GameState_Size() {
+    return game_state_end - game_state_begin;
+}
 
-    GS_SAVE(cmd_sel);
-    GS_SAVE(no_sa);
+void* GameState_Locate(const GameState* gs, const void* member) {
+    return (u8*)gs->data + ((const u8*)member - game_state_begin);
+}
 
-    // sc_sub
+void GameState_Save(GameState* dst) {
+    check_arena();
 
-    GS_SAVE(Hnc_Num);
-    GS_SAVE(end_w);
-    GS_SAVE(scr_sc);
-    GS_SAVE(X_Adjust);
-    GS_SAVE(Y_Adjust);
+#if defined(GAME_STATE_BENCHMARK)
+    run_benchmark();
+#endif
 
-    GS_SAVE(BgMATRIX);
-    GS_SAVE(vm_w);
-    GS_SAVE(ck_ex_option);
-    GS_SAVE(X_Adjust_Buff);
-    GS_SAVE(Y_Adjust_Buff);
+    SDL_memcpy(dst->data, game_state_begin, GameState_Size());
 }
 
-#define GS_LOAD(member) SDL_memcpy(&member, &src->member, sizeof(member))
-
 void GameState_Load(const GameState* src) {
-    GS_LOAD(Scene_Cut);
-    GS_LOAD(Time_Over);
-    GS_LOAD(round_timer);
-    GS_LOAD(flash_timer);
-    GS_LOAD(flash_r_num);
-    GS_LOAD(flash_col);
-    GS_LOAD(math_counter_hi);
-    GS_LOAD(math_counter_low);
-    GS_LOAD(counter_color);
-    GS_LOAD(mugen_flag);
-    GS_LOAD(hoji_counter);
-    GS_LOAD(select_timer_state);
-    GS_LOAD(Order);
-    GS_LOAD(Order_Timer);
-    GS_LOAD(Order_Dir);
-    GS_LOAD(Score);
-    GS_LOAD(Complete_Bonus);
-    GS_LOAD(Stock_Score);
-    GS_LOAD(Vital_Bonus);
-    GS_LOAD(Time_Bonus);
-    GS_LOAD(Stage_Stock_Score);
-    GS_LOAD(Bonus_Score);
-    GS_LOAD(Final_Bonus_Score);
-    GS_LOAD(WGJ_Score);
-    GS_LOAD(Bonus_Score_Plus);
-    GS_LOAD(Perfect_Bonus);
-    GS_LOAD(Keep_Score);
-    GS_LOAD(Disp_Score_Buff);
-    GS_LOAD(Winner_id);
-    GS_LOAD(Loser_id);
-    GS_LOAD(Break_Into);
-    GS_LOAD(My_char);
-    GS_LOAD(Allow_a_battle_f);
-    GS_LOAD(Round_num);
-    GS_LOAD(Complete_Judgement);
-    GS_LOAD(Fade_Flag);
-    GS_LOAD(Super_Arts);
-    GS_LOAD(Forbid_Break);
-    GS_LOAD(Request_Break);
-    GS_LOAD(Continue_Count);
-    GS_LOAD(Counter_hi);
-    GS_LOAD(Counter_low);
-    GS_LOAD(Unit_Of_Timer);
-    GS_LOAD(Select_Timer);
-    GS_LOAD(Cursor_X);
-    GS_LOAD(Cursor_Y);
-    GS_LOAD(Cursor_Y_Pos);
-    GS_LOAD(Cursor_Timer);
-    GS_LOAD(Time_Stop);
-    GS_LOAD(Suicide);
-    GS_LOAD(Complete_Face);
-    GS_LOAD(Play_Type);
-    GS_LOAD(Sel_PL_Complete);
-    GS_LOAD(New_Challenger);
-    GS_LOAD(S_No);
-    GS_LOAD(Select_Start);
-    GS_LOAD(request_message);
-    GS_LOAD(judge_flag);
-    GS_LOAD(WINNER);
-    GS_LOAD(LOSER);
-    GS_LOAD(Champion);
-    GS_LOAD(Fade_Half_Flag);
-    GS_LOAD(Reserve_Cut);
-    GS_LOAD(Perfect_Flag);
-    GS_LOAD(Next_Step);
-    GS_LOAD(Switch_Type);
-    GS_LOAD(Cover_Timer);
-    GS_LOAD(Personal_Timer);
-    GS_LOAD(Request_E_No);
-    GS_LOAD(Request_G_No);
-    GS_LOAD(Present_Rank);
-    GS_LOAD(Best_Grade);
-    GS_LOAD(Demo_Type);
-    GS_LOAD(Rank_Type);
-    GS_LOAD(Flash_Sign);
-    GS_LOAD(Flash_Rank_Time);
-    GS_LOAD(Flash_Rank_Interval);
-    GS_LOAD(Ranking_X);
-    GS_LOAD(Rank);
-    GS_LOAD(Rank_X);
-    GS_LOAD(E_07_Flag);
-    GS_LOAD(Complete_Victory);
-    GS_LOAD(Demo_Flag);
-    GS_LOAD(Next_Demo);
-    GS_LOAD(Demo_PL_Index);
-    GS_LOAD(Demo_Stage_Index);
-    GS_LOAD(Face_MV_Request);
-    GS_LOAD(Face_Move);
-    GS_LOAD(Player_id);
-    GS_LOAD(Last_Player_id);
-    GS_LOAD(Player_Number);
-    GS_LOAD(DENJIN_Term);
-    GS_LOAD(Rapid_No);
-    GS_LOAD(COM_id);
-    GS_LOAD(EM_id);
-    GS_LOAD(Select_Status);
-    GS_LOAD(Select_Demo_Index);
-    GS_LOAD(Country);
-    GS_LOAD(Demo_Time_Stop);
-    GS_LOAD(Combo_Speed);
-    GS_LOAD(Exec_Wipe);
-    GS_LOAD(Passive_Mode);
-    GS_LOAD(Passive_Flag);
-    GS_LOAD(Flip_Flag);
-    GS_LOAD(Lie_Flag);
-    GS_LOAD(Counter_Attack);
-    GS_LOAD(Attack_Flag);
-    GS_LOAD(Limited_Flag);
-    GS_LOAD(Shell_Ignore_Timer);
-    GS_LOAD(Event_Judge_Gals);
-    GS_LOAD(EJG_index);
-    GS_LOAD(Guard_Flag);
-    GS_LOAD(Pierce_Menu);
-    GS_LOAD(Face_MV_Time);
-    GS_LOAD(Before_Jump);
-    GS_LOAD(Stop_Combo);
-    GS_LOAD(Stock_Hit_Flag);
-    GS_LOAD(Rolling_Flag);
-    GS_LOAD(Continue_Coin);
-    GS_LOAD(Ignore_Entry);
-    GS_LOAD(Slide_Type);
-    GS_LOAD(Moving_Plate);
-    GS_LOAD(Naming_Cut);
-    GS_LOAD(Moving_Plate_Counter);
-    GS_LOAD(Player_Color);
-    GS_LOAD(PP_Priority);
-    GS_LOAD(OK_Priority);
-    GS_LOAD(Stock_My_char);
-    GS_LOAD(Stock_Player_Color);
-    GS_LOAD(Music_Fade);
-    GS_LOAD(Stop_SG);
-    GS_LOAD(Operator_Status);
-    GS_LOAD(Round_Operator);
-    GS_LOAD(another_bg);
-    GS_LOAD(Last_Super_Arts);
-    GS_LOAD(Last_My_char);
-    GS_LOAD(Continue_Menu);
-    GS_LOAD(Timer_Freeze);
-    GS_LOAD(Type_of_Attack);
-    GS_LOAD(Standing_Timer);
-    GS_LOAD(Before_Look);
-    GS_LOAD(Attack_Count_No0);
-    GS_LOAD(Standing_Master_Timer);
-    GS_LOAD(PB_Music_Off);
-    GS_LOAD(No_Death);
-    GS_LOAD(Flash_MT);
-    GS_LOAD(Squat_Timer);
-    GS_LOAD(Squat_Master_Timer);
-    GS_LOAD(Turn_Over);
-    GS_LOAD(Turn_Over_Timer);
-    GS_LOAD(Jump_Pass_Timer);
-    GS_LOAD(sa_gauge_flash);
-    GS_LOAD(Receive_Flag);
-    GS_LOAD(Disposal_Again);
-    GS_LOAD(BGM_Vol);
-    GS_LOAD(Used_char);
-    GS_LOAD(Break_Com);
-    GS_LOAD(aiuchi_flag);
-    GS_LOAD(paring_counter);
-    GS_LOAD(paring_bonus_r);
-    GS_LOAD(paring_ctr_vs);
-    GS_LOAD(paring_ctr_ori);
-    GS_LOAD(Attack_Count_Buff);
-    GS_LOAD(Attack_Count_Index);
-    GS_LOAD(CC_Value);
-    GS_LOAD(Continue_Coin2);
-    GS_LOAD(Weak_PL);
-    GS_LOAD(Bullet_No);
-    GS_LOAD(Bullet_Counter);
-    GS_LOAD(Final_Result_id);
-    GS_LOAD(Disp_Win_Name);
-    GS_LOAD(Perfect_Counter);
-    GS_LOAD(Straight_Counter);
-    GS_LOAD(Appear_Q);
-    GS_LOAD(Cut_Scroll);
-    GS_LOAD(Break_Into_CPU);
-    GS_LOAD(ID_of_Face);
-    GS_LOAD(Cursor_Move);
-    GS_LOAD(Auto_Cursor);
-    GS_LOAD(Auto_No);
-    GS_LOAD(Auto_Index);
-    GS_LOAD(Auto_Timer);
-    GS_LOAD(Explosion);
-    GS_LOAD(Introduce_Break_Into);
-    GS_LOAD(gouki_wins);
-    GS_LOAD(EM_Rank);
-    GS_LOAD(Disp_PERFECT);
-    GS_LOAD(Escape_SS);
-    GS_LOAD(Deley_Shot_No);
-    GS_LOAD(Deley_Shot_Timer);
-    GS_LOAD(Lost_Round);
-    GS_LOAD(Super_Arts_Finish);
-    GS_LOAD(Stage_SA_Finish);
-    GS_LOAD(Perfect_Finish);
-    GS_LOAD(Cheap_Finish);
-    GS_LOAD(Last_My_char2);
-    GS_LOAD(gouki_app);
-    GS_LOAD(Bonus_Game_Complete);
-    GS_LOAD(Get_Demo_Index);
-    GS_LOAD(Combo_Demo_Flag);
-    GS_LOAD(Stage_Continue);
-    GS_LOAD(Pause_Hit_Marks);
-    GS_LOAD(Extra_Break);
-    GS_LOAD(Shin_Gouki_BGM);
-    GS_LOAD(Stage_Lost_Round);
-    GS_LOAD(Stage_Perfect_Finish);
-    GS_LOAD(Stage_Cheap_Finish);
-    GS_LOAD(EXE_obroll);
-    GS_LOAD(End_PL);
-    GS_LOAD(Stock_Com_Arts);
-    GS_LOAD(PB_Status);
-    GS_LOAD(Flip_Counter);
-    GS_LOAD(Stage_Time_Finish);
-    GS_LOAD(Bonus_Type);
-    GS_LOAD(Completion_Bonus);
-    GS_LOAD(ichikannkei);
-    GS_LOAD(Plate_Disposal_No);
-    GS_LOAD(SO_No);
-    GS_LOAD(Disp_Command_Name);
-    GS_LOAD(SC_No);
-    GS_LOAD(BGM_No);
-    GS_LOAD(BGM_Timer);
-    GS_LOAD(EM_List);
-    GS_LOAD(Sel_EM_Complete);
-    GS_LOAD(Temporary_EM);
-    GS_LOAD(OK_Moving_SA_Plate);
-    GS_LOAD(Battle_Q);
-    GS_LOAD(EM_History);
-    GS_LOAD(GO_No);
-    GS_LOAD(Aborigine);
-    GS_LOAD(Continue_Count_Down);
-    GS_LOAD(WGJ_Target);
-    GS_LOAD(EM_Candidate);
-    GS_LOAD(Last_Selected_EM);
-    GS_LOAD(Q_Country);
-    GS_LOAD(Continue_Cut);
-    GS_LOAD(Introduce_Boss);
-    GS_LOAD(Final_Play_Type);
-    GS_LOAD(Rank_In);
-    GS_LOAD(Request_Disp_Rank);
-    GS_LOAD(Reset_Timer);
-    GS_LOAD(bbbs_type);
-    GS_LOAD(Straight_Flag);
-    GS_LOAD(kakushi_ix);
-    GS_LOAD(kakushi_op);
-    GS_LOAD(RO_backup);
-    GS_LOAD(PT_backup);
-    GS_LOAD(E_Number);
-    GS_LOAD(E_No);
-    GS_LOAD(C_No);
-    GS_LOAD(G_No);
-    GS_LOAD(D_No);
-    GS_LOAD(M_No);
-    GS_LOAD(Exit_No);
-    GS_LOAD(SP_No);
-    GS_LOAD(Face_No);
-    GS_LOAD(Stop_Cursor);
-    GS_LOAD(Training_Index);
-    GS_LOAD(Connect_Status);
-    GS_LOAD(Menu_Suicide);
-    GS_LOAD(Game_pause);
-    GS_LOAD(Game_difficulty);
-    GS_LOAD(Pause);
-    GS_LOAD(Pause_ID);
-    GS_LOAD(Exit_Menu);
-    GS_LOAD(Conclusion_Flag);
-    GS_LOAD(CP_No);
-    GS_LOAD(CP_Index);
-    GS_LOAD(Gap_Timer);
-    GS_LOAD(Message_Suicide);
-    GS_LOAD(Disp_Cockpit);
-    GS_LOAD(Select_Arts);
-    GS_LOAD(Lamp_No);
-    GS_LOAD(Lamp_Index);
-    GS_LOAD(Lamp_Color);
-    GS_LOAD(Stop_Update_Score);
-    GS_LOAD(test_flag);
-    GS_LOAD(ixbfw_cut);
-    GS_LOAD(Cont_No);
-    GS_LOAD(PL_Wins);
-    GS_LOAD(Fade_R_No0);
-    GS_LOAD(Fade_R_No1);
-    GS_LOAD(Conclusion_Type);
-    GS_LOAD(win_type);
-    GS_LOAD(message_index);
-    GS_LOAD(F_No0);
-    GS_LOAD(F_No1);
-    GS_LOAD(F_No2);
-    GS_LOAD(F_No3);
-    GS_LOAD(keep_condition);
-    GS_LOAD(Check_Buff);
-    GS_LOAD(Convert_Buff);
-    GS_LOAD(Unsubstantial_BG);
-    GS_LOAD(Menu_Cursor_X);
-    GS_LOAD(Menu_Cursor_Y);
-    GS_LOAD(Replay_Status);
-    GS_LOAD(Disappear_LOGO);
-    GS_LOAD(count_end);
-    GS_LOAD(Play_Game);
-    GS_LOAD(Menu_Cursor_Move);
-    GS_LOAD(flash_win_type);
-    GS_LOAD(sync_win_type);
-    GS_LOAD(Mode_Type);
-    GS_LOAD(Menu_Page);
-    GS_LOAD(Menu_Max);
-    GS_LOAD(reset_NG_flag);
-    GS_LOAD(VS_Stage);
-    GS_LOAD(Present_Mode);
-    GS_LOAD(Play_Mode);
-    GS_LOAD(Page_Max);
-    GS_LOAD(Direction_Working);
-    GS_LOAD(Vital_Handicap);
-    GS_LOAD(Cursor_Limit);
-    GS_LOAD(Synchro_No);
-    GS_LOAD(SA_shadow_on);
-    GS_LOAD(Pause_Down);
-    GS_LOAD(Training_ID);
-    GS_LOAD(Disp_Attack_Data);
-    GS_LOAD(Record_Data_Tr);
-    GS_LOAD(End_Training);
-    GS_LOAD(Menu_Page_Buff);
-    GS_LOAD(Reset_Bootrom);
-    GS_LOAD(Decide_ID);
-    GS_LOAD(Training_Cursor);
-    GS_LOAD(Lag_Timer);
-    GS_LOAD(CPU_Time_Lag);
-    GS_LOAD(Forbid_Reset);
-    GS_LOAD(CPU_Rec);
-    GS_LOAD(Pause_Type);
-    GS_LOAD(Game_timer);
-    GS_LOAD(Control_Time);
-    GS_LOAD(Time_in_Time);
-    GS_LOAD(Round_Level);
-    GS_LOAD(Round_Result);
-    GS_LOAD(Fade_Number);
-    GS_LOAD(G_Timer);
-    GS_LOAD(D_Timer);
-    GS_LOAD(Rank_Pos_X);
-    GS_LOAD(Rank_Pos_Y);
-    GS_LOAD(E_Timer);
-    GS_LOAD(F_Timer);
-    GS_LOAD(ENTRY_X);
-    GS_LOAD(C_Timer);
-    GS_LOAD(S_Timer);
-    GS_LOAD(Flash_Complete);
-    GS_LOAD(Sel_Arts_Complete);
-    GS_LOAD(Arts_Y);
-    GS_LOAD(Move_Super_Arts);
-    GS_LOAD(Battle_Country);
-    GS_LOAD(Face_Status);
-    GS_LOAD(ID);
-    GS_LOAD(ID2);
-    GS_LOAD(mes_already);
-    GS_LOAD(Timer_00);
-    GS_LOAD(Timer_01);
-    GS_LOAD(PL_Distance);
-    GS_LOAD(Area_Number);
-    GS_LOAD(Lever_Buff);
-    GS_LOAD(Lever_Pool);
-    GS_LOAD(Tech_Index);
-    GS_LOAD(Random_ix16);
-    GS_LOAD(Random_ix32);
-    GS_LOAD(M_Timer);
-    GS_LOAD(VS_Tech);
-    GS_LOAD(Guard_Type);
-    GS_LOAD(Separate_Area);
-    GS_LOAD(Free_Lever);
-    GS_LOAD(Term_No);
-    GS_LOAD(Com_Width_Data);
-    GS_LOAD(Lever_Squat);
-    GS_LOAD(M_Lv);
-    GS_LOAD(Insert_Y);
-    GS_LOAD(scr_req_x);
-    GS_LOAD(scr_req_y);
-    GS_LOAD(zoom_req_flag_old);
-    GS_LOAD(zoom_request_flag);
-    GS_LOAD(zoom_request_level);
-    GS_LOAD(Last_Selected_ID);
-    GS_LOAD(Last_Called_SE);
-    GS_LOAD(VS_Index);
-    GS_LOAD(Rapid_Index);
-    GS_LOAD(Shell_Separate_Area);
-    GS_LOAD(Attack_Counter);
-    GS_LOAD(Last_Attack_Counter);
-    GS_LOAD(Pattern_Index);
-    GS_LOAD(Com_Color_Shot);
-    GS_LOAD(Resume_Lever);
-    GS_LOAD(players_timer);
-    GS_LOAD(Lever_Store);
-    GS_LOAD(Return_CP_No);
-    GS_LOAD(Return_CP_Index);
-    GS_LOAD(Return_Pattern_Index);
-    GS_LOAD(Lever_LR);
-    GS_LOAD(Last_Eftype);
-    GS_LOAD(DENJIN_No);
-    GS_LOAD(SC_Personal_Time);
-    GS_LOAD(Guard_Counter);
-    GS_LOAD(Limit_Time);
-    GS_LOAD(Last_Pattern_Index);
-    GS_LOAD(Random_ix16_ex);
-    GS_LOAD(Random_ix32_ex);
-    GS_LOAD(DE_X);
-    GS_LOAD(Exit_Timer);
-    GS_LOAD(Max_vitality);
-    GS_LOAD(Bonus_Game_Flag);
-    GS_LOAD(Bonus_Game_Work);
-    GS_LOAD(Bonus_Game_result);
-    GS_LOAD(Stock_Bonus_Game_Result);
-    GS_LOAD(bs_scrrrl);
-    GS_LOAD(Bonus_Stage_RNO);
-    GS_LOAD(Bonus_Stage_Level);
-    GS_LOAD(Bonus_Stage_Tix);
-    GS_LOAD(Bonus_Game_ex_result);
-    GS_LOAD(Stock_Com_Color);
-    GS_LOAD(bs2_floor);
-    GS_LOAD(bs2_hosei);
-    GS_LOAD(bs2_current_damage);
-    GS_LOAD(Win_Record);
-    GS_LOAD(Stock_Win_Record);
-    GS_LOAD(WGJ_Win);
-    GS_LOAD(Target_BG_X);
-    GS_LOAD(Offset_BG_X);
-    GS_LOAD(Result_Timer);
-    GS_LOAD(scrl);
-    GS_LOAD(scrr);
-    GS_LOAD(vital_stop_flag);
-    GS_LOAD(gauge_stop_flag);
-    GS_LOAD(Lamp_Timer);
-    GS_LOAD(Cont_Timer);
-    GS_LOAD(Plate_X);
-    GS_LOAD(Plate_Y);
-    // GS_LOAD(Demo_Timer);
-    // GS_LOAD(Condense_Buff);
-    GS_LOAD(Keep_Grade);
-    GS_LOAD(IO_Result);
-    GS_LOAD(VS_Win_Record);
-    GS_LOAD(PLsw);
-    GS_LOAD(plsw_00);
-    GS_LOAD(plsw_01);
-    GS_LOAD(Flash_Synchro);
-    GS_LOAD(Synchro_Level);
-    GS_LOAD(Random_ix16_com);
-    GS_LOAD(Random_ix32_com);
-    GS_LOAD(Random_ix16_ex_com);
-    GS_LOAD(Random_ix32_ex_com);
-    GS_LOAD(Random_ix16_bg);
-    GS_LOAD(Opening_Now);
-    GS_LOAD(task);
-
-    // plcnt
-
-    GS_LOAD(plw);
-    GS_LOAD(zanzou_table);
-    GS_LOAD(super_arts);
-    GS_LOAD(piyori_type);
-    GS_LOAD(appear_type);
-    GS_LOAD(pcon_rno);
-    GS_LOAD(round_slow_flag);
-    GS_LOAD(pcon_dp_flag);
-    GS_LOAD(win_sp_flag);
-    GS_LOAD(dead_voice_flag);
-    GS_LOAD(rambod);
-    GS_LOAD(ramhan);
-    GS_LOAD(vital_inc_timer);
-    GS_LOAD(vital_dec_timer);
-    GS_LOAD(sag_inc_timer);
-
-    // cmd_data
-
-    GS_LOAD(wcp);
-    GS_LOAD(t_pl_lvr);
-    GS_LOAD(waza_work);
-
-    // cmb_win
-
-    GS_LOAD(cmst_buff);
-    GS_LOAD(old_cmb_flag);
-    GS_LOAD(cmb_stock);
-    GS_LOAD(first_attack);
-    GS_LOAD(rever_attack);
-    GS_LOAD(paring_attack);
-    GS_LOAD(bonus_pts);
-    GS_LOAD(hit_num);
-    GS_LOAD(sa_kind);
-    GS_LOAD(end_flag);
-    GS_LOAD(calc_hit);
-    GS_LOAD(score_calc);
-    GS_LOAD(cmb_all_stock);
-    GS_LOAD(sarts_finish_flag);
-    GS_LOAD(last_hit_time);
-    GS_LOAD(cmb_calc_now);
-    GS_LOAD(cst_read);
-    GS_LOAD(cst_write);
-
-    // bg
-
-    GS_LOAD(bg_w);
-
-    // charset
-
-    GS_LOAD(att_req);
-
-    // slowf
-
-    GS_LOAD(SLOW_timer);
-    GS_LOAD(SLOW_flag);
-    GS_LOAD(EXE_flag);
-
-    // grade
-
-    GS_LOAD(judge_gals);
-    GS_LOAD(judge_com);
-    GS_LOAD(last_judge_dada);
-    GS_LOAD(judge_final);
-    GS_LOAD(judge_item);
-    GS_LOAD(ji_sat);
-
-    // spgauge
-
-    GS_LOAD(Old_Stop_SG);
-    GS_LOAD(Exec_Wipe_F);
-    GS_LOAD(time_clear);
-    GS_LOAD(spg_number);
-    GS_LOAD(spg_work);
-    GS_LOAD(spg_offset);
-    GS_LOAD(time_num);
-    GS_LOAD(time_timer);
-    GS_LOAD(time_flag);
-    GS_LOAD(col);
-    GS_LOAD(time_operate);
-    GS_LOAD(sast_now);
-    GS_LOAD(max2);
-    GS_LOAD(max_rno2);
-    GS_LOAD(spg_dat);
-
-    // stun
-
-    GS_LOAD(sdat);
-
-    // vital
-
-    GS_LOAD(vit);
-
-    // win_pl
-
-    GS_LOAD(win_free);
-    GS_LOAD(win_rno);
-    GS_LOAD(poison_flag);
-
-    // ta_sub
-
-    GS_LOAD(eff_hit_flag);
-
-    // sc_sub
-
-    GS_LOAD(FadeLimit);
-    GS_LOAD(WipeLimit);
-
-    // appear
-
-    GS_LOAD(Appear_car_stop);
-    GS_LOAD(Appear_hv);
-    GS_LOAD(Appear_free);
-    GS_LOAD(Appear_flag);
-    GS_LOAD(app_counter);
-    GS_LOAD(appear_work);
-    GS_LOAD(Appear_end);
-
-    // bg_data
-
-    GS_LOAD(y_sitei_pos);
-    GS_LOAD(y_sitei_flag);
-    GS_LOAD(c_number);
-    GS_LOAD(c_kakikae);
-    GS_LOAD(g_number);
-    GS_LOAD(g_kakikae);
-    GS_LOAD(nosekae);
-    GS_LOAD(scrn_adgjust_y);
-    GS_LOAD(scrn_adgjust_x);
-    GS_LOAD(zoom_add);
-    GS_LOAD(ls_cnt1);
-    GS_LOAD(bg_app);
-    GS_LOAD(sa_pa_flag);
-    GS_LOAD(aku_flag);
-    GS_LOAD(seraph_flag);
-    GS_LOAD(akebono_flag);
-    GS_LOAD(bg_mvxy);
-    GS_LOAD(chase_time_y);
-    GS_LOAD(chase_time_x);
-    GS_LOAD(chase_y);
-    GS_LOAD(chase_x);
-    GS_LOAD(demo_car_flag);
-    GS_LOAD(ideal_w);
-    GS_LOAD(bg_app_stop);
-    GS_LOAD(bg_stop);
-    GS_LOAD(base_y_pos);
-    GS_LOAD(etcBgPalCnvTable);
-    GS_LOAD(etcBgGixCnvTable);
-
-    // eff56
-
-    GS_LOAD(ci_pointer);
-    GS_LOAD(ci_col);
-    GS_LOAD(ci_timer);
-
-    // effb2
-
-    GS_LOAD(rf_b2_flag);
-    GS_LOAD(b2_curr_no);
-
-    // effb8
-
-    GS_LOAD(test_pl_no);
-    GS_LOAD(test_mes_no);
-    GS_LOAD(test_in);
-    GS_LOAD(old_mes_no2);
-    GS_LOAD(old_mes_no3);
-    GS_LOAD(old_mes_no_pl);
-    GS_LOAD(mes_timer);
-
-    // work_sys — rollback-critical state
-
-    GS_LOAD(bg_pos);
-    GS_LOAD(fm_pos);
-    GS_LOAD(bg_prm);
-    GS_LOAD(system_timer);
-    GS_LOAD(Gill_Appear_Flag);
-
-    // plcnt — DIP switch combat config
-
-    GS_LOAD(cmd_sel);
-    GS_LOAD(no_sa);
-
-    // sc_sub
-
-    GS_LOAD(Hnc_Num);
-    GS_LOAD(end_w);
-    GS_LOAD(scr_sc);
-    GS_LOAD(X_Adjust);
-    GS_LOAD(Y_Adjust);
-
-    GS_LOAD(BgMATRIX);
-    GS_LOAD(vm_w);
-    GS_LOAD(ck_ex_option);
-    GS_LOAD(X_Adjust_Buff);
-    GS_LOAD(Y_Adjust_Buff);
+    SDL_memcpy(game_state_begin, src->data, GameState_Size());
 }
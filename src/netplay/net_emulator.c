@@ -0,0 +1,243 @@
+#include "netplay/net_emulator.h"
+#include "common.h"
+
+#include <SDL3/SDL.h>
+
+#define QUEUE_LIMIT_MS 250 // Packets that would wait longer than this for bandwidth are dropped
+
+typedef struct Packet {
+    Uint64 due_ns;
+    GekkoNetAddress addr;
+    char* data;
+    int length;
+} Packet;
+
+typedef struct NetEmulator {
+    GekkoNetAdapter* base;
+    GekkoNetAdapter adapter;
+    NetEmulationConfig config;
+    u64 rng;
+    bool in_burst;
+    Uint64 link_free_ns; // When the emulated link is done sending what's queued
+    Uint64 last_due_ns;  // Packets leave in order unless they're reordered
+
+    // Packets in flight, sorted by due time
+    Packet* queue;
+    int queue_count;
+    int queue_capacity;
+
+    u64 sent;
+    u64 dropped;
+    u64 reordered;
+} NetEmulator;
+
+static NetEmulator emulator = { 0 };
+
+/// splitmix64, so that a seed always produces the same conditions
+static u64 next_random() {
+    u64 z = (emulator.rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/// @return Uniformly distributed number in [0, 1).
+static double random_unit() {
+    return (next_random() >> 11) * (1.0 / (1ULL << 53));
+}
+
+bool NetEmulator_Parse(const char* spec, NetEmulationConfig* config) {
+    char buffer[256];
+    char* saveptr = NULL;
+
+    SDL_zerop(config);
+    config->seed = 1;
+    SDL_strlcpy(buffer, spec, sizeof(buffer));
+
+    for (char* token = SDL_strtok_r(buffer, ",", &saveptr); token != NULL; token = SDL_strtok_r(NULL, ",", &saveptr)) {
+        char* value = SDL_strchr(token, '=');
+
+        if (value == NULL) {
+            return false;
+        }
+
+        *value = '\0';
+        value += 1;
+
+        if (SDL_strcmp(token, "latency") == 0) {
+            config->latency_ms = SDL_atoi(value);
+        } else if (SDL_strcmp(token, "jitter") == 0) {
+            config->jitter_ms = SDL_atoi(value);
+        } else if (SDL_strcmp(token, "loss") == 0) {
+            config->loss = SDL_atof(value);
+        } else if (SDL_strcmp(token, "burst") == 0) {
+            config->burst = SDL_atof(value);
+        } else if (SDL_strcmp(token, "reorder") == 0) {
+            config->reorder = SDL_atof(value);
+        } else if (SDL_strcmp(token, "bandwidth") == 0) {
+            config->bandwidth = SDL_atoi(value);
+        } else if (SDL_strcmp(token, "seed") == 0) {
+            config->seed = SDL_strtoull(value, NULL, 10);
+        } else {
+            return false;
+        }
+    }
+
+    return (config->latency_ms >= 0) && (config->jitter_ms >= 0) && (config->jitter_ms <= config->latency_ms) &&
+           (config->loss >= 0) && (config->loss < 1) && (config->reorder >= 0) && (config->reorder <= 1) &&
+           (config->bandwidth >= 0);
+}
+
+/// Gilbert-Elliott loss: drops come in runs of `burst` packets on average,
+/// while the overall fraction of dropped packets stays at `loss`.
+static bool should_drop() {
+    const NetEmulationConfig* config = &emulator.config;
+
+    if (config->loss <= 0) {
+        return false;
+    }
+
+    if (config->burst <= 1) {
+        return random_unit() < config->loss;
+    }
+
+    if (emulator.in_burst) {
+        emulator.in_burst = random_unit() >= 1.0 / config->burst;
+    } else {
+        emulator.in_burst = random_unit() < config->loss / (config->burst * (1 - config->loss));
+    }
+
+    return emulator.in_burst;
+}
+
+static void enqueue(const Packet* packet) {
+    if (emulator.queue_count == emulator.queue_capacity) {
+        emulator.queue_capacity = SDL_max(emulator.queue_capacity * 2, 64);
+        emulator.queue = SDL_realloc(emulator.queue, emulator.queue_capacity * sizeof(Packet));
+
+        if (emulator.queue == NULL) {
+            fatal_error("Failed to grow the network emulation queue");
+        }
+    }
+
+    int i = emulator.queue_count;
+
+    while ((i > 0) && (emulator.queue[i - 1].due_ns > packet->due_ns)) {
+        emulator.queue[i] = emulator.queue[i - 1];
+        i -= 1;
+    }
+
+    emulator.queue[i] = *packet;
+    emulator.queue_count += 1;
+}
+
+static void free_packet(Packet* packet) {
+    SDL_free(packet->addr.data);
+    SDL_free(packet->data);
+}
+
+static void deliver_due_packets() {
+    const Uint64 now = SDL_GetTicksNS();
+    int delivered = 0;
+
+    while ((delivered < emulator.queue_count) && (emulator.queue[delivered].due_ns <= now)) {
+        Packet* packet = &emulator.queue[delivered];
+        emulator.base->send_data(&packet->addr, packet->data, packet->length);
+        free_packet(packet);
+        delivered += 1;
+    }
+
+    emulator.queue_count -= delivered;
+    SDL_memmove(emulator.queue, emulator.queue + delivered, emulator.queue_count * sizeof(Packet));
+}
+
+static void NetEmulator_SendData(GekkoNetAddress* addr, const char* data, int length) {
+    const NetEmulationConfig* config = &emulator.config;
+    const Uint64 now = SDL_GetTicksNS();
+    Uint64 depart_ns = now;
+
+    if (should_drop()) {
+        emulator.dropped += 1;
+        return;
+    }
+
+    if (config->bandwidth > 0) {
+        depart_ns = SDL_max(emulator.link_free_ns, now) + (Uint64)length * SDL_NS_PER_SECOND / config->bandwidth;
+
+        if (depart_ns - now > SDL_MS_TO_NS(QUEUE_LIMIT_MS)) {
+            emulator.dropped += 1;
+            return;
+        }
+
+        emulator.link_free_ns = depart_ns;
+    }
+
+    Packet packet;
+    packet.length = length;
+    packet.data = SDL_malloc(length);
+    packet.addr.size = addr->size;
+    packet.addr.data = SDL_malloc(addr->size);
+    SDL_memcpy(packet.data, data, length);
+    SDL_memcpy(packet.addr.data, addr->data, addr->size);
+
+    if (random_unit() < config->reorder) {
+        // Like netem, reordered packets go out right away and overtake the delayed ones
+        packet.due_ns = depart_ns;
+        emulator.reordered += 1;
+    } else {
+        const int jitter_ms = (config->jitter_ms > 0)
+                                  ? (int)(next_random() % (2 * config->jitter_ms + 1)) - config->jitter_ms
+                                  : 0;
+        packet.due_ns = depart_ns + SDL_MS_TO_NS(config->latency_ms + jitter_ms);
+        packet.due_ns = SDL_max(packet.due_ns, emulator.last_due_ns);
+        emulator.last_due_ns = packet.due_ns;
+    }
+
+    enqueue(&packet);
+    emulator.sent += 1;
+    deliver_due_packets();
+}
+
+static GekkoNetResult** NetEmulator_ReceiveData(int* length) {
+    // GekkoNet polls once per frame, so that's also how often delayed packets go out
+    deliver_due_packets();
+    return emulator.base->receive_data(length);
+}
+
+GekkoNetAdapter* NetEmulator_Begin(GekkoNetAdapter* adapter, const NetEmulationConfig* config) {
+    NetEmulator_End();
+
+    emulator.base = adapter;
+    emulator.config = *config;
+    emulator.rng = config->seed;
+    emulator.adapter.send_data = NetEmulator_SendData;
+    emulator.adapter.receive_data = NetEmulator_ReceiveData;
+    emulator.adapter.free_data = adapter->free_data;
+    return &emulator.adapter;
+}
+
+void NetEmulator_Report() {
+    const NetEmulationConfig* config = &emulator.config;
+
+    SDL_Log("[net emulation] latency %d±%d ms, loss %.3f (bursts of %.1f), reorder %.3f, bandwidth %d B/s, seed %" SDL_PRIu64
+            " | sent %" SDL_PRIu64 ", dropped %" SDL_PRIu64 ", reordered %" SDL_PRIu64,
+            config->latency_ms,
+            config->jitter_ms,
+            config->loss,
+            config->burst,
+            config->reorder,
+            config->bandwidth,
+            config->seed,
+            emulator.sent,
+            emulator.dropped,
+            emulator.reordered);
+}
+
+void NetEmulator_End() {
+    for (int i = 0; i < emulator.queue_count; i++) {
+        free_packet(&emulator.queue[i]);
+    }
+
+    SDL_free(emulator.queue);
+    SDL_zero(emulator);
+}
@@ -0,0 +1,39 @@
+#ifndef NETPLAY_NET_EMULATOR_H
+#define NETPLAY_NET_EMULATOR_H
+
+#include "types.h"
+
+#include <stdbool.h>
+
+#define Game GekkoGame // workaround: upstream GekkoSessionType::Game collides with void Game()
+#include "gekkonet.h"
+#undef Game
+
+/// Network conditions applied to outgoing packets.
+typedef struct NetEmulationConfig {
+    int latency_ms; // One-way delay
+    int jitter_ms;  // Delay varies uniformly by up to this much in either direction
+    float loss;     // Fraction of packets that are dropped
+    float burst;    // Mean length of a run of dropped packets
+    float reorder;  // Fraction of packets that skip the delay and overtake earlier ones
+    int bandwidth;  // Bytes per second, 0 for no limit
+    u64 seed;
+} NetEmulationConfig;
+
+/// Parse a comma separated list of settings, e.g.
+/// `latency=60,jitter=8,loss=0.02,burst=3,reorder=0.01,bandwidth=32000,seed=7`.
+/// Settings that are left out are 0 (seed 1).
+/// @return `false` if `spec` has an unknown setting or a malformed value.
+bool NetEmulator_Parse(const char* spec, NetEmulationConfig* config);
+
+/// Put the emulated network between GekkoNet and `adapter`.
+/// @return Adapter to hand to GekkoNet.
+GekkoNetAdapter* NetEmulator_Begin(GekkoNetAdapter* adapter, const NetEmulationConfig* config);
+
+/// Log the conditions and how many packets were dropped, reordered and sent.
+void NetEmulator_Report();
+
+/// Drop the packets that are still in flight.
+void NetEmulator_End();
+
+#endif
@@ -1,5 +1,11 @@
 #include "netplay/netplay.h"
 #include "netplay/game_state.h"
+#include "netplay/net_emulator.h"
+#include "netplay/pointer_handle.h"
+#include "netplay/relay.h"
+#include "netplay/telemetry.h"
+#include "port/sdl/sdl_app.h"
+#include "sf33rd/AcrSDK/common/pad.h"
 #include "sf33rd/Source/Game/Game.h"
 #include "sf33rd/Source/Game/effect/effect.h"
 #include "sf33rd/Source/Game/engine/grade.h"
@@ -12,9 +18,11 @@
 #include "sf33rd/Source/Game/rendering/dc_ghost.h"
 #include "sf33rd/Source/Game/rendering/mtrans.h"
 #include "sf33rd/Source/Game/rendering/texcash.h"
+#include "sf33rd/Source/Game/sound/sound3rd.h"
 #include "sf33rd/Source/Game/system/sys_sub.h"
 #include "sf33rd/Source/Game/system/work_sys.h"
 #include "sf33rd/utils/djb2_hash.h"
+#include "sf33rd/utils/xxhash64.h"
 #include "types.h"
 
 #include <stdbool.h>
@@ -24,37 +32,89 @@
 #undef Game
 #include <SDL3/SDL.h>
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #define INPUT_HISTORY_MAX 120
-
-// Uncomment to enable packet drops
-// #define LOSSY_ADAPTER
+#define SPECTATOR_MAX 4
+#define SPECTATOR_PORT 50002
+#define VIEWER_CATCH_UP_MAX 30 // Frames a relay viewer simulates per update while catching up
+#define VIEWER_BUFFER_FRAMES 6 // Frames a relay viewer keeps in hand to ride out jitter
+
+#define FRAME_TIME_MS (1000.0 / 59.59949)
+#define TIME_SYNC_SMOOTHING 0.05       // Weight of the newest frame advantage sample
+#define TIME_SYNC_GAIN 0.01            // Frame time adjustment per frame of advantage
+#define TIME_SYNC_MAX_ADJUSTMENT 0.02  // Frames are stretched or shrunk by at most this much
+#define CATCH_UP_FRAMES 3              // Falling further behind than this is caught up by skipping frames
+#define INPUT_DELAY_MAX 4
+#define INPUT_DELAY_INTERVAL 120       // Frames between two input delay changes
+#define ROLLBACK_BUDGET_FRAMES 2       // Latency that is left to rollback instead of input delay
+#define NET_EMULATION_REPORT_FRAMES 600 // Frames between reports while network emulation is on
+#define RUN_AHEAD_MAX 4
+#define RUN_AHEAD_STATS_FRAMES 60    // Frames per run-ahead overlay update
+#define RUN_AHEAD_REPORT_FRAMES 600  // Frames between run-ahead timing logs
+
+// Uncomment to log sparse vs. full effect snapshot cost
+// #define EFFECT_STATE_BENCHMARK
+
+// Uncomment to checksum states with djb2 instead of xxHash64
+// #define STATE_HASH_DJB2
+
+// Uncomment to log state hashing throughput of xxHash64 and djb2
+// #define STATE_HASH_BENCHMARK
 
 typedef enum SessionState {
     SESSION_IDLE,
     SESSION_TRANSITIONING,
     SESSION_CONNECTING,
     SESSION_RUNNING,
+    SESSION_SYNC_TEST,
+    SESSION_VIEWING,
     SESSION_EXITING,
 } SessionState;
 
+typedef enum NetplayRole {
+    ROLE_PLAYER,
+    ROLE_SPECTATOR, // Watches a player through GekkoNet and relays the inputs to viewers
+    ROLE_VIEWER,    // Watches through a spectator's relay
+} NetplayRole;
+
+/// Sparse snapshot of the effect pool.
+///
+/// Only slots that are linked into one of the `head_ix`/`tail_ix` lists are stored.
+/// Free slots are always kept zeroed by `push_effect_work` (apart from their
+/// `myself`/`before`/`behind` fields), so they can be rebuilt on load without
+/// being saved.
 typedef struct EffectState {
     s16 frwctr;
     s16 frwctr_min;
     s16 head_ix[8];
     s16 tail_ix[8];
     s16 exec_tm[8];
-    uintptr_t frw[EFFECT_MAX][448];
     s16 frwque[EFFECT_MAX];
+    s16 live_count;
+    s16 live_ix[EFFECT_MAX]; // Pool index of each entry in frw, zero past live_count
+
+    // Live slots, packed in list order. Only the first live_count entries are valid.
+    // Must stay the last member so that the unused tail can be left out of the snapshot.
+    uintptr_t frw[EFFECT_MAX][448];
 } EffectState;
 
+/// A saved state is the part of the arena that's in use, directly followed by the effects.
+/// `State` only reserves room for the largest arena, so the effects are reached through
+/// `state_effects()`. `es` is where they'd start after an arena of that size, and where
+/// `dump_state` writes them so that dumps follow the layout of `State`.
 typedef struct State {
     GameState gs;
-    EffectState es;
+    EffectState es; // Must stay the last member, see EffectState
 } State;
 
+/// @return The effects of a state, which start right after the part of the arena that's in use.
+static EffectState* state_effects(const State* state) {
+    return (EffectState*)((u8*)state + ALIGN_UP(GameState_Size(), _Alignof(EffectState)));
+}
+
 static GekkoSession* session = NULL;
 static unsigned short local_port = 0;
 static unsigned short remote_port = 0;
@@ -62,34 +122,77 @@ static const char* remote_ip = NULL;
 static int player_number = 0;
 static int player_handle = 0;
 static SessionState session_state = SESSION_IDLE;
+static NetplayRole role = ROLE_PLAYER;
+static const char* spectator_ips[SPECTATOR_MAX] = { NULL };
+static int spectator_count = 0;
 static u16 input_history[2][INPUT_HISTORY_MAX] = { 0 };
 static float frames_behind = 0;
-static int frame_skip_timer = 0;
 
-#if defined(DEBUG)
-#define STATE_BUFFER_MAX 20
-#endif
-
-#if defined(LOSSY_ADAPTER)
-static GekkoNetAdapter* base_adapter = NULL;
-static GekkoNetAdapter lossy_adapter = { 0 };
+typedef struct TimeSync {
+    float frames_ahead; // Smoothed frame advantage over the remote player
+    GekkoNetworkStats stats;
+    int input_delay;
+    int input_delay_timer;
+} TimeSync;
 
-static float random_float() {
-    return (float)rand() / RAND_MAX;
-}
+static TimeSync time_sync = { 0 };
 
-static void LossyAdapter_SendData(GekkoNetAddress* addr, const char* data, int length) {
-    const float number = random_float();
+#if defined(EFFECT_STATE_BENCHMARK)
+#define EFFECT_STATE_BENCHMARK_INTERVAL 600
 
-    // Adjust this number to change drop probability
-    if (number <= 0.25) {
-        return;
-    }
+typedef struct EffectStateBenchmark {
+    Uint64 frames;
+    Uint64 sparse_bytes;
+    Uint64 sparse_save_ns;
+    Uint64 sparse_load_ns;
+    Uint64 full_save_ns;
+    Uint64 full_load_ns;
+} EffectStateBenchmark;
 
-    base_adapter->send_data(addr, data, length);
-}
+static EffectStateBenchmark effect_benchmark = { 0 };
 #endif
 
+#define STATE_BUFFER_MAX 20
+#define SYNC_TEST_REPORT_INTERVAL 600
+#define SYNC_TEST_START_PULSE_FRAMES 8 // Start is pressed and released this often until the main menu
+#define SYNC_TEST_HOLD_FRAMES_MAX 20   // Random inputs are held for up to this many frames
+
+static int sync_test_frames = 0; // Rollback depth of the sync test, 0 when disabled
+static int sync_test_frame_count = 0; // Frames to run before the test passes
+static Uint64 sync_test_rng = 0;
+static bool sync_test_started = false;
+static int sync_test_exit_status = -1; // -1 until the test is over
+static int sync_test_frame = 0;
+static int sync_test_rollbacks = 0;
+static Uint64 sync_test_rollback_ns = 0;
+static u16 sync_test_inputs[2] = { 0 };
+static int sync_test_hold[2] = { 0 };
+
+static bool net_emulation_enabled = false;
+static NetEmulationConfig net_emulation = { 0 };
+static int net_emulation_report_timer = 0;
+static const char* telemetry_path = NULL;
+static int next_frame = 0; // Frame the next AdvanceEvent simulates
+static bool desync_detection = true;
+
+/// Time spent on run-ahead over a window of frames.
+typedef struct RunAheadStats {
+    int frames;
+    Uint64 step_ns;   // The frame that counts
+    Uint64 save_ns;
+    Uint64 hidden_ns; // All frames that are simulated ahead
+    Uint64 load_ns;
+    Uint64 total_max_ns;
+} RunAheadStats;
+
+static int run_ahead_frames = 0; // Frames simulated ahead of the real one, 0 when disabled
+static State run_ahead_state;
+static RunAheadStats run_ahead_stats = { 0 };
+static int run_ahead_report_timer = 0;
+static char run_ahead_overlay[128];
+static bool has_run_ahead_overlay = false;
+static bool is_running_ahead = false;
+
 static void clean_input_buffers() {
     p1sw_0 = 0;
     p2sw_0 = 0;
@@ -151,15 +254,6 @@ static void setup_vs_mode() {
     clean_input_buffers();
 }
 
-#if defined(LOSSY_ADAPTER)
-static void configure_lossy_adapter() {
-    base_adapter = gekko_default_adapter(local_port);
-    lossy_adapter.send_data = LossyAdapter_SendData;
-    lossy_adapter.receive_data = base_adapter->receive_data;
-    lossy_adapter.free_data = base_adapter->free_data;
-}
-#endif
-
 static void configure_gekko() {
     GekkoConfig config;
     SDL_zero(config);
@@ -167,25 +261,34 @@ static void configure_gekko() {
     config.num_players = 2;
     config.input_size = sizeof(u16);
     config.state_size = sizeof(State);
-    config.max_spectators = 0;
+    config.max_spectators = spectator_count;
     config.input_prediction_window = 10;
 
-#if defined(DEBUG)
-    config.desync_detection = true;
-#endif
+    // Spectators that connect after the start are let in, so that they can be told why they
+    // can't watch, see process_events. GekkoNet doesn't send them the frames they missed.
+    config.post_sync_joining = true;
+
+    config.desync_detection = desync_detection && (role == ROLE_PLAYER);
 
-    if (gekko_create(&session, GekkoGame)) {
+    if (gekko_create(&session, (role == ROLE_SPECTATOR) ? Spectate : GekkoGame)) {
         gekko_start(session, &config);
     } else {
         printf("Session is already running! probably incorrect.\n");
     }
 
-#if defined(LOSSY_ADAPTER)
-    configure_lossy_adapter();
-    gekko_net_adapter_set(session, &lossy_adapter);
-#else
-    gekko_net_adapter_set(session, gekko_default_adapter(local_port));
-#endif
+    Telemetry_Begin(telemetry_path);
+
+    GekkoNetAdapter* adapter = gekko_default_adapter(local_port);
+
+    if (net_emulation_enabled) {
+        adapter = NetEmulator_Begin(adapter, &net_emulation);
+    }
+
+    if (role == ROLE_SPECTATOR) {
+        adapter = Relay_Begin(adapter);
+    }
+
+    gekko_net_adapter_set(session, adapter);
 
     printf("starting a session for player %d at port %hu\n", player_number, local_port);
 
@@ -193,6 +296,12 @@ static void configure_gekko() {
     SDL_snprintf(remote_address_str, sizeof(remote_address_str), "%s:%hu", remote_ip, remote_port);
     GekkoNetAddress remote_address = { .data = remote_address_str, .size = strlen(remote_address_str) };
 
+    if (role == ROLE_SPECTATOR) {
+        // The player we watch is the only actor of a spectator session
+        gekko_add_actor(session, RemotePlayer, &remote_address);
+        return;
+    }
+
     if (player_number == 0) {
         player_handle = gekko_add_actor(session, LocalPlayer, NULL);
         gekko_add_actor(session, RemotePlayer, &remote_address);
@@ -200,6 +309,13 @@ static void configure_gekko() {
         gekko_add_actor(session, RemotePlayer, &remote_address);
         player_handle = gekko_add_actor(session, LocalPlayer, NULL);
     }
+
+    for (int i = 0; i < spectator_count; i++) {
+        char spectator_address_str[100];
+        SDL_snprintf(spectator_address_str, sizeof(spectator_address_str), "%s:%d", spectator_ips[i], SPECTATOR_PORT);
+        GekkoNetAddress spectator_address = { .data = spectator_address_str, .size = strlen(spectator_address_str) };
+        gekko_add_actor(session, Spectator, &spectator_address);
+    }
 }
 
 static u16 get_inputs() {
@@ -227,47 +343,78 @@ static u16 recall_input(int player, int frame) {
     return input_history[player][frame % INPUT_HISTORY_MAX];
 }
 
-#if defined(DEBUG)
+static size_t effect_state_size(const EffectState* es) {
+    return offsetof(EffectState, frw) + es->live_count * sizeof(es->frw[0]);
+}
+
+/// Size of the prefix of a state that has to be stored. Everything past it is stale data.
+static size_t state_size(const State* state) {
+    const EffectState* es = state_effects(state);
+    return ((const u8*)es - (const u8*)state) + effect_state_size(es);
+}
+
+typedef uint64_t StateHash;
+
+static StateHash hash_init() {
+#if defined(STATE_HASH_DJB2)
+    return djb2_init();
+#else
+    return 0;
+#endif
+}
+
+/// Continue `hash` over `len` bytes of `data`.
+static StateHash hash_update(StateHash hash, const void* data, size_t len) {
+#if defined(STATE_HASH_DJB2)
+    return djb2_update_mem((uint32_t)hash, data, len);
+#else
+    // Chain by using the hash so far as the seed
+    return xxh64(data, len, hash);
+#endif
+}
+
 // Per-subsystem checksums for faster desync triage — when a desync fires,
 // we can immediately tell which section (player, bg, effects...) diverged.
 typedef struct {
-    uint32_t plw0;
-    uint32_t plw1;
-    uint32_t bg;
-    uint32_t tasks;
-    uint32_t effects;
-    uint32_t globals;
-    uint32_t combined;
+    StateHash plw0;
+    StateHash plw1;
+    StateHash bg;
+    StateHash tasks;
+    StateHash effects;
+    StateHash globals;
+    StateHash combined;
 } SectionedChecksum;
 
 static SectionedChecksum calculate_sectioned_checksums(const State* state) {
+    const EffectState* es = state_effects(state);
     SectionedChecksum sc;
 
-    uint32_t h;
+    StateHash h;
 
-    h = djb2_init();
-    h = djb2_update_mem(h, (const uint8_t*)&state->gs.plw[0], sizeof(PLW));
+    h = hash_init();
+    h = hash_update(h, &GS_MEMBER(&state->gs, plw)[0], sizeof(PLW));
     sc.plw0 = h;
 
-    h = djb2_init();
-    h = djb2_update_mem(h, (const uint8_t*)&state->gs.plw[1], sizeof(PLW));
+    h = hash_init();
+    h = hash_update(h, &GS_MEMBER(&state->gs, plw)[1], sizeof(PLW));
     sc.plw1 = h;
 
-    h = djb2_init();
-    h = djb2_update_mem(h, (const uint8_t*)&state->gs.bg_w, sizeof(state->gs.bg_w));
+    h = hash_init();
+    h = hash_update(h, &GS_MEMBER(&state->gs, bg_w), sizeof(bg_w));
     sc.bg = h;
 
-    h = djb2_init();
-    h = djb2_update_mem(h, (const uint8_t*)&state->gs.task, sizeof(state->gs.task));
+    h = hash_init();
+    h = hash_update(h, &GS_MEMBER(&state->gs, task), sizeof(task));
     sc.tasks = h;
 
-    h = djb2_init();
-    h = djb2_update_mem(h, (const uint8_t*)&state->es, sizeof(EffectState));
+    h = hash_init();
+    h = hash_update(h, es, effect_state_size(es));
     sc.effects = h;
 
     // Combined hash covers the entire state (for GekkoNet exchange)
-    h = djb2_init();
-    h = djb2_updatep(h, state);
+    h = hash_init();
+    h = hash_update(h, state->gs.data, GameState_Size());
+    h = hash_update(h, es, effect_state_size(es));
     sc.combined = h;
 
     // Rough diagnostic only: XOR is not a proper remainder hash,
@@ -277,15 +424,22 @@ static SectionedChecksum calculate_sectioned_checksums(const State* state) {
     return sc;
 }
 
-
 static State state_buffer[STATE_BUFFER_MAX];
 
 static void dump_state(const State* src, const char* filename) {
+    // The unused tail of gs isn't saved, write zeros in its place so that dumps can be diffed
+    static const u8 zeros[sizeof(GameState)] = { 0 };
+    const size_t gs_size = GameState_Size();
+    const EffectState* es = state_effects(src);
+
     SDL_IOStream* io = SDL_IOFromFile(filename, "w");
-    SDL_WriteIO(io, src, sizeof(State));
+    SDL_WriteIO(io, &src->gs, gs_size);
+    SDL_WriteIO(io, zeros, offsetof(State, es) - gs_size);
+    SDL_WriteIO(io, es, effect_state_size(es));
     SDL_CloseIO(io);
 }
 
+#if defined(DEBUG)
 static void dump_saved_state(int frame) {
     const State* src = &state_buffer[frame % STATE_BUFFER_MAX];
 
@@ -298,24 +452,151 @@ static void dump_saved_state(int frame) {
 
 #define SDL_copya(dst, src) SDL_memcpy(dst, src, sizeof(src))
 
-static void gather_state(State* dst) {
-    // GameState
-    GameState* gs = &dst->gs;
-    GameState_Save(gs);
+static void gather_effects(EffectState* es) {
+    // Everything before frw is saved and hashed, including the unused tail of live_ix and the
+    // padding before frw. Clear them so that they don't carry over from the previous save.
+    SDL_memset(es, 0, offsetof(EffectState, frw));
 
-    // EffectState
-    EffectState* es = &dst->es;
-    SDL_copya(es->frw, frw);
     SDL_copya(es->exec_tm, exec_tm);
     SDL_copya(es->frwque, frwque);
     SDL_copya(es->head_ix, head_ix);
     SDL_copya(es->tail_ix, tail_ix);
     es->frwctr = frwctr;
     es->frwctr_min = frwctr_min;
+    es->live_count = 0;
+
+    for (int i = 0; i < SDL_arraysize(head_ix); i++) {
+        for (s16 ix = head_ix[i]; ix != -1; ix = ((WORK*)frw[ix])->behind) {
+            es->live_ix[es->live_count] = ix;
+            SDL_copya(es->frw[es->live_count], frw[ix]);
+            PointerHandle_EncodeEffect((WORK_Other*)es->frw[es->live_count]);
+            es->live_count += 1;
+        }
+    }
+}
+
+/// Put a pool slot back into the state `push_effect_work` leaves free slots in.
+static void reset_effect_slot(s16 ix) {
+    WORK* w = (WORK*)frw[ix];
+    SDL_zeroa(frw[ix]);
+    w->before = w->behind = -1;
+    w->myself = ix;
 }
 
+static void load_effects(const EffectState* es) {
+    // Slots that are live right now may be free in the snapshot. Free slots are
+    // already in their reset state, so only the live ones need to be touched.
+    for (int i = 0; i < SDL_arraysize(head_ix); i++) {
+        s16 ix = head_ix[i];
+
+        while (ix != -1) {
+            const s16 next_ix = ((WORK*)frw[ix])->behind;
+            reset_effect_slot(ix);
+            ix = next_ix;
+        }
+    }
+
+    for (int i = 0; i < es->live_count; i++) {
+        const s16 ix = es->live_ix[i];
+        SDL_copya(frw[ix], es->frw[i]);
+        PointerHandle_DecodeEffect((WORK_Other*)frw[ix]);
+    }
+
+    SDL_copya(exec_tm, es->exec_tm);
+    SDL_copya(frwque, es->frwque);
+    SDL_copya(head_ix, es->head_ix);
+    SDL_copya(tail_ix, es->tail_ix);
+    frwctr = es->frwctr;
+    frwctr_min = es->frwctr_min;
+}
+
+/// Replace the pointers in a saved GameState with handles, so that the snapshot
+/// doesn't depend on where this process has its code and data.
+static void encode_game_pointers(GameState* gs) {
+    PointerHandle_EncodePlayer(&GS_MEMBER(gs, plw)[0]);
+    PointerHandle_EncodePlayer(&GS_MEMBER(gs, plw)[1]);
+    GS_MEMBER(gs, ci_pointer) = (const u8*)PointerHandle_Encode(GS_MEMBER(gs, ci_pointer));
+
+    for (int i = 0; i < SDL_arraysize(task); i++) {
+        struct _TASK* t = &GS_MEMBER(gs, task)[i];
+        t->func_adrs = (void (*)())PointerHandle_Encode((const void*)t->func_adrs);
+    }
+}
+
+/// Turn the handles of a loaded GameState back into pointers.
+static void decode_game_pointers() {
+    PointerHandle_DecodePlayer(&plw[0]);
+    PointerHandle_DecodePlayer(&plw[1]);
+    ci_pointer = PointerHandle_Decode((PointerHandle)ci_pointer);
+
+    for (int i = 0; i < SDL_arraysize(task); i++) {
+        task[i].func_adrs = (void (*)())PointerHandle_Decode((PointerHandle)task[i].func_adrs);
+    }
+}
+
+static void gather_state(State* dst) {
+    // GameState
+    GameState* gs = &dst->gs;
+    GameState_Save(gs);
+    encode_game_pointers(gs);
+
+    // Alignment padding between the arena and the effects
+    u8* arena_end = gs->data + GameState_Size();
+    SDL_memset(arena_end, 0, (u8*)state_effects(dst) - arena_end);
+
+    // EffectState
+    gather_effects(state_effects(dst));
+}
+
+#if defined(EFFECT_STATE_BENCHMARK)
+static void report_effect_benchmark() {
+    const EffectStateBenchmark* b = &effect_benchmark;
+    const double frames = (double)b->frames;
+
+    SDL_Log("[effects] sparse: %.0f B/frame, save %.0f ns, load %.0f ns | full: %zu B/frame, save %.0f ns, load %.0f ns",
+            b->sparse_bytes / frames,
+            b->sparse_save_ns / frames,
+            b->sparse_load_ns / frames,
+            sizeof(frw),
+            b->full_save_ns / frames,
+            b->full_load_ns / frames);
+
+    SDL_zero(effect_benchmark);
+}
+
+/// Time the sparse save/load round trip against copying the whole pool, on the
+/// live effect pool of the current frame. Leaves the pool unchanged.
+static void benchmark_effects() {
+    static EffectState sparse;
+    static uintptr_t full[EFFECT_MAX][448];
+    EffectStateBenchmark* b = &effect_benchmark;
+    Uint64 start;
+
+    start = SDL_GetTicksNS();
+    gather_effects(&sparse);
+    b->sparse_save_ns += SDL_GetTicksNS() - start;
+    b->sparse_bytes += effect_state_size(&sparse);
+
+    start = SDL_GetTicksNS();
+    load_effects(&sparse);
+    b->sparse_load_ns += SDL_GetTicksNS() - start;
+
+    start = SDL_GetTicksNS();
+    SDL_copya(full, frw);
+    b->full_save_ns += SDL_GetTicksNS() - start;
+
+    start = SDL_GetTicksNS();
+    SDL_copya(frw, full);
+    b->full_load_ns += SDL_GetTicksNS() - start;
+
+    b->frames += 1;
+
+    if (b->frames >= EFFECT_STATE_BENCHMARK_INTERVAL) {
+        report_effect_benchmark();
+    }
+}
+#endif
 
-#if defined(DEBUG)
 // These effect IDs use the WORK_Other_CONN layout (variable-length conn[] tail).
 // Derived by auditing every effXX.c that casts to WORK_Other_CONN*.
 static bool is_work_other_conn(int id) {
@@ -349,42 +630,6 @@ static void sanitize_work_other_conn(WORK* w) {
     }
 }
 
-/// Zero pointer fields so they don't pollute checksums (ASLR makes them differ).
-/// Only ever called on a scratch copy — never on a state Gekko will restore.
-static void sanitize_work_pointers(WORK* w) {
-    w->target_adrs = NULL;
-    w->hit_adrs = NULL;
-    w->dmg_adrs = NULL;
-    w->suzi_offset = NULL;
-    SDL_zeroa(w->char_table);
-    w->se_random_table = NULL;
-    w->step_xy_table = NULL;
-    w->move_xy_table = NULL;
-    w->overlap_char_tbl = NULL;
-    w->olc_ix_table = NULL;
-    w->rival_catch_tbl = NULL;
-    w->curr_rca = NULL;
-    w->set_char_ad = NULL;
-    w->hit_ix_table = NULL;
-    w->body_adrs = NULL;
-    w->h_bod = NULL;
-    w->hand_adrs = NULL;
-    w->h_han = NULL;
-    w->dumm_adrs = NULL;
-    w->h_dumm = NULL;
-    w->catch_adrs = NULL;
-    w->h_cat = NULL;
-    w->caught_adrs = NULL;
-    w->h_cau = NULL;
-    w->attack_adrs = NULL;
-    w->h_att = NULL;
-    w->h_eat = NULL;
-    w->hosei_adrs = NULL;
-    w->h_hos = NULL;
-    w->att_ix_table = NULL;
-    w->my_effadrs = NULL;
-}
-
 /// Mask rendering-only bits/fields from WORK color fields.
 /// - current_colcd, my_col_code: strip 0x2000 player-side palette flag
 /// - colcd: fully zeroed (derived from current_colcd by rendering, can differ entirely)
@@ -397,37 +642,369 @@ static void sanitize_work_rendering(WORK* w) {
     w->extra_col_2   &= ~0x2000;
 }
 
-/// Zero all pointer fields and mask rendering bits in a PLW struct.
-static void sanitize_plw_pointers(PLW* p) {
-    sanitize_work_pointers(&p->wu);
-    sanitize_work_rendering(&p->wu);
-    p->cp = NULL;
-    p->dm_step_tbl = NULL;
-    p->as = NULL;
-    p->sa = NULL;
-    p->py = NULL;
+/// Sanitize ONLY non-functional data in a state (safe for rollback restore):
+/// - Inactive effect slots: zero everything (be_flag == 0 means unused)
+/// - Padding arrays: wrd_free, et_free (never read by game logic)
+/// - WORK_Other_CONN unused tail entries (beyond num_of_conn)
+/// IMPORTANT: Do NOT zero pointer fields here — Gekko loads this state
+/// on rollback, and NULL pointers would crash the game immediately.
+static void sanitize_state(State* dst) {
+    EffectState* es = state_effects(dst);
+    for (int i = 0; i < es->live_count; i++) {
+        WORK* w = (WORK*)es->frw[i];
+        if (w->be_flag == 0) {
+            // Slot unused — zero everything except linked-list pointers
+            // (before/behind/myself) which the effect system needs intact.
+            s16 before = w->before;
+            s16 behind = w->behind;
+            s16 myself = w->myself;
+            SDL_memset(es->frw[i], 0, sizeof(es->frw[i]));
+            w->before = before;
+            w->behind = behind;
+            w->myself = myself;
+        } else {
+            // Active slot: zero only padding (safe for rollback)
+            SDL_zeroa(w->wrd_free);
+
+            WORK_Other* wo = (WORK_Other*)w;
+            SDL_zeroa(wo->et_free);
+
+            if (is_work_other_conn(w->id)) {
+                sanitize_work_other_conn(w);
+            }
+        }
+    }
+}
+
+#if defined(STATE_HASH_BENCHMARK)
+#define STATE_HASH_BENCHMARK_INTERVAL 600
+
+/// Hash a real state with both functions and log their throughput every few hundred states.
+static void benchmark_state_hash(const State* state) {
+    static Uint64 bytes = 0;
+    static Uint64 xxh64_ns = 0;
+    static Uint64 djb2_ns = 0;
+    static int count = 0;
+    static volatile uint64_t sink;
+    const EffectState* es = state_effects(state);
+    Uint64 start;
+
+    start = SDL_GetTicksNS();
+    sink = xxh64(state->gs.data, GameState_Size(), 0);
+    sink = xxh64((const uint8_t*)es, effect_state_size(es), sink);
+    xxh64_ns += SDL_GetTicksNS() - start;
+
+    start = SDL_GetTicksNS();
+    sink = djb2_update_mem(djb2_init(), state->gs.data, GameState_Size());
+    sink = djb2_update_mem((uint32_t)sink, (const uint8_t*)es, effect_state_size(es));
+    djb2_ns += SDL_GetTicksNS() - start;
+
+    bytes += state_size(state);
+    count += 1;
+
+    if (count >= STATE_HASH_BENCHMARK_INTERVAL) {
+        // Bytes per nanosecond is GB/s
+        SDL_Log("[state hash] %" SDL_PRIu64 " B/state | xxh64: %.2f GB/s | djb2: %.2f GB/s",
+                bytes / count,
+                (double)bytes / xxh64_ns,
+                (double)bytes / djb2_ns);
+
+        bytes = xxh64_ns = djb2_ns = 0;
+        count = 0;
+    }
 }
+#endif
 
-/// Save state in state buffer.
-/// @return Mutable pointer to state as it has been saved.
-static State* note_state(const State* state, int frame) {
-    if (frame < 0) {
-        frame += STATE_BUFFER_MAX;
+/// Checksum a state, leaving out rendering-only data.
+/// Pointers are already stored as handles, which are the same in every process.
+/// The rendering-only data is masked in place, so `state` must not be loaded afterwards.
+static SectionedChecksum checksum_state(State* state) {
+    GameState* gs = &state->gs;
+    sanitize_work_rendering(&GS_MEMBER(gs, plw)[0].wu);
+    sanitize_work_rendering(&GS_MEMBER(gs, plw)[1].wu);
+
+    EffectState* es = state_effects(state);
+    for (int i = 0; i < es->live_count; i++) {
+        WORK* w = (WORK*)es->frw[i];
+        if (w->be_flag != 0) {
+            sanitize_work_rendering(w);
+        }
     }
 
-    State* dst = &state_buffer[frame % STATE_BUFFER_MAX];
-    SDL_memcpy(dst, state, sizeof(State));
-    return dst;
+    // Zero viewport/resolution-dependent background rendering state
+    // (bg_pos, bg_prm, BgMATRIX differ between peers due to window size)
+    SDL_zeroa(GS_MEMBER(gs, bg_pos));
+    SDL_zeroa(GS_MEMBER(gs, bg_prm));
+    SDL_zeroa(GS_MEMBER(gs, BgMATRIX));
+
+#if defined(STATE_HASH_BENCHMARK)
+    benchmark_state_hash(state);
+#endif
+
+    return calculate_sectioned_checksums(state);
+}
+
+// Checksumming a full state takes longer than the rest of a save, so saves only
+// publish a copy of the state and a worker thread does the hashing, rollback
+// comparison and dumping. SaveEvents come out of gekko_update_session, and GekkoNet
+// isn't called again before process_session flushes the pipeline, so every checksum
+// is in place before GekkoNet runs again, just as if it had been written by the save.
+// A save slot can be reused by a later save before then, e.g. in a long rollback,
+// so a result is only written if its frame is still the newest one of the slot.
+
+#define CHECKSUM_JOB_MAX 12 // Enough for a full prediction window of resimulated saves
+#define CHECKSUM_SLOT_MAX 32 // More than the save slots GekkoNet cycles through
+
+typedef struct ChecksumJob {
+    int frame;
+    unsigned int* checksum; // Lives in GekkoNet's save slot, only written on the main thread
+    StateHash result;
+    State state;
+} ChecksumJob;
+
+/// Newest frame that was saved into one of GekkoNet's save slots.
+typedef struct ChecksumSlot {
+    unsigned int* checksum;
+    int frame;
+} ChecksumSlot;
+
+typedef struct ChecksumPipeline {
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* job_added;
+    SDL_Condition* job_done;
+    ChecksumJob jobs[CHECKSUM_JOB_MAX];
+
+    // Monotonic job counters: [head, done) are finished, [done, tail) are queued
+    int head;
+    int done;
+    int tail;
+    bool quit;
+
+    // Only used on the main thread
+    ChecksumSlot slots[CHECKSUM_SLOT_MAX];
+    int slot_count;
+} ChecksumPipeline;
+
+static ChecksumPipeline checksum_pipeline;
+
+#if defined(DEBUG)
+/// Compare a resimulated frame's effects against the forward one and record it.
+/// Runs on the checksum worker, which owns `state_buffer` while the pipeline is up.
+static void track_rollback(const State* state, const SectionedChecksum* sc, int frame) {
+    // Track forward fx hash per frame using a ringbuffer.
+    // When rollback replays a frame, compare & dump.
+    enum { FX_RING_SIZE = 32 };
+    static StateHash fx_ring[FX_RING_SIZE] = { 0 };
+    static int max_forward_frame = -1;
+
+    if (frame > max_forward_frame) {
+        // Forward simulation: record the fx hash
+        fx_ring[frame % FX_RING_SIZE] = sc->effects;
+        max_forward_frame = frame;
+        return;
+    }
+
+    // Rollback replay: compare with stored forward hash
+    StateHash fwd = fx_ring[frame % FX_RING_SIZE];
+    bool matches = (sc->effects == fwd);
+    SDL_Log("[P%d F%d] ROLLBACK fx=%016" SDL_PRIX64 " (fwd=%016" SDL_PRIX64 ") %s",
+            local_port, frame, sc->effects, fwd,
+            matches ? "OK" : "DIVERGED!");
+
+    if (!matches) {
+        // Dump the ROLLBACK state for offline diff
+        char fname[100];
+        SDL_snprintf(fname, sizeof(fname), "states/rollback_%d_%d", local_port, frame);
+        dump_state(state, fname);
+
+        // The forward state is still in its slot, it gets replaced after this
+        SDL_snprintf(fname, sizeof(fname), "states/forward_%d_%d", local_port, frame);
+        dump_state(&state_buffer[frame % STATE_BUFFER_MAX], fname);
+    }
+
+    // Update the ringbuffer with the rollback hash (GekkoNet uses this one)
+    fx_ring[frame % FX_RING_SIZE] = sc->effects;
 }
 #endif
 
+static void process_checksum_job(ChecksumJob* job) {
+    // The job owns its copy of the state, so it can be checksummed in place.
+    // Saved states are only kept for reports, so the masked copy is recorded.
+    const SectionedChecksum sc = checksum_state(&job->state);
+    job->result = sc.combined;
+
+#if defined(DEBUG)
+    track_rollback(&job->state, &sc, job->frame);
+    SDL_memcpy(&state_buffer[job->frame % STATE_BUFFER_MAX], &job->state, state_size(&job->state));
+#endif
+}
+
+static int SDLCALL checksum_worker(void* data) {
+    ChecksumPipeline* pipeline = data;
+
+    SDL_LockMutex(pipeline->mutex);
+
+    while (true) {
+        while (pipeline->done == pipeline->tail && !pipeline->quit) {
+            SDL_WaitCondition(pipeline->job_added, pipeline->mutex);
+        }
+
+        if (pipeline->done == pipeline->tail) {
+            break;
+        }
+
+        // The job's slot isn't touched by the main thread until it's marked done
+        ChecksumJob* job = &pipeline->jobs[pipeline->done % CHECKSUM_JOB_MAX];
+        SDL_UnlockMutex(pipeline->mutex);
+        process_checksum_job(job);
+        SDL_LockMutex(pipeline->mutex);
+
+        pipeline->done += 1;
+        SDL_SignalCondition(pipeline->job_done);
+    }
+
+    SDL_UnlockMutex(pipeline->mutex);
+    return 0;
+}
+
+static void start_checksum_pipeline() {
+    ChecksumPipeline* pipeline = &checksum_pipeline;
+
+    pipeline->head = 0;
+    pipeline->done = 0;
+    pipeline->tail = 0;
+    pipeline->quit = false;
+    pipeline->slot_count = 0;
+    pipeline->mutex = SDL_CreateMutex();
+    pipeline->job_added = SDL_CreateCondition();
+    pipeline->job_done = SDL_CreateCondition();
+    pipeline->thread = SDL_CreateThread(checksum_worker, "checksum", pipeline);
+
+    if (pipeline->thread == NULL) {
+        fatal_error("Failed to start checksum worker: %s", SDL_GetError());
+    }
+}
+
+/// @return Where the newest frame saved into the slot of `checksum` is kept.
+static ChecksumSlot* find_checksum_slot(ChecksumPipeline* pipeline, const unsigned int* checksum) {
+    for (int i = 0; i < pipeline->slot_count; i++) {
+        if (pipeline->slots[i].checksum == checksum) {
+            return &pipeline->slots[i];
+        }
+    }
+
+    if (pipeline->slot_count == CHECKSUM_SLOT_MAX) {
+        fatal_error("GekkoNet uses more than %d save slots", CHECKSUM_SLOT_MAX);
+    }
+
+    ChecksumSlot* slot = &pipeline->slots[pipeline->slot_count];
+    pipeline->slot_count += 1;
+    slot->checksum = (unsigned int*)checksum;
+    slot->frame = -1;
+    return slot;
+}
+
+/// Hand finished checksums back to GekkoNet.
+/// @param wait Block until every published job is finished.
+/// Must be called with the pipeline's mutex held.
+static void collect_checksums(ChecksumPipeline* pipeline, bool wait) {
+    while (pipeline->head != pipeline->tail) {
+        if (pipeline->head == pipeline->done) {
+            if (!wait) {
+                break;
+            }
+
+            SDL_WaitCondition(pipeline->job_done, pipeline->mutex);
+            continue;
+        }
+
+        const ChecksumJob* job = &pipeline->jobs[pipeline->head % CHECKSUM_JOB_MAX];
+
+        // Otherwise the slot holds a newer frame, whose own job writes its checksum
+        if (find_checksum_slot(pipeline, job->checksum)->frame == job->frame) {
+            *job->checksum = xxh64_fold32(job->result);
+        }
+
+        pipeline->head += 1;
+    }
+}
+
+static void flush_checksum_pipeline() {
+    ChecksumPipeline* pipeline = &checksum_pipeline;
+
+    if (pipeline->thread == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(pipeline->mutex);
+    collect_checksums(pipeline, true);
+    SDL_UnlockMutex(pipeline->mutex);
+}
+
+static void stop_checksum_pipeline() {
+    ChecksumPipeline* pipeline = &checksum_pipeline;
+
+    if (pipeline->thread == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(pipeline->mutex);
+    pipeline->quit = true;
+    SDL_SignalCondition(pipeline->job_added);
+    SDL_UnlockMutex(pipeline->mutex);
+
+    // The worker drains the queue before quitting, no checksums are handed out anymore
+    SDL_WaitThread(pipeline->thread, NULL);
+    SDL_DestroyCondition(pipeline->job_done);
+    SDL_DestroyCondition(pipeline->job_added);
+    SDL_DestroyMutex(pipeline->mutex);
+    pipeline->thread = NULL;
+}
+
+static void publish_checksum_job(const State* state, int frame, unsigned int* checksum) {
+    ChecksumPipeline* pipeline = &checksum_pipeline;
+
+    find_checksum_slot(pipeline, checksum)->frame = frame;
+    SDL_LockMutex(pipeline->mutex);
+
+    // Keep the ring from overflowing when the worker falls behind a long rollback
+    if (pipeline->tail - pipeline->head == CHECKSUM_JOB_MAX) {
+        while (pipeline->head == pipeline->done) {
+            SDL_WaitCondition(pipeline->job_done, pipeline->mutex);
+        }
+
+        collect_checksums(pipeline, false);
+    }
+
+    SDL_UnlockMutex(pipeline->mutex);
+
+    // The slot at tail is free, so it can be filled without holding the lock
+    ChecksumJob* job = &pipeline->jobs[pipeline->tail % CHECKSUM_JOB_MAX];
+    job->frame = frame;
+    job->checksum = checksum;
+    SDL_memcpy(&job->state, state, state_size(state));
+
+    SDL_LockMutex(pipeline->mutex);
+    pipeline->tail += 1;
+    SDL_SignalCondition(pipeline->job_added);
+    SDL_UnlockMutex(pipeline->mutex);
+}
+
 static void save_state(GekkoGameEvent* event) {
-    *event->data.save.state_len = sizeof(State);
     State* dst = (State*)event->data.save.state;
 
+#if defined(EFFECT_STATE_BENCHMARK)
+    benchmark_effects();
+#endif
+
     gather_state(dst);
+    *event->data.save.state_len = state_size(dst);
+
+    if (!desync_detection || (role != ROLE_PLAYER)) {
+        return;
+    }
 
-#if defined(DEBUG)
     const int frame = event->data.save.frame;
 
     // Wait for battle to actually start (G_No[1] == 2 means Game2_0 has run)
@@ -448,143 +1025,21 @@ static void save_state(GekkoGameEvent* event) {
     const bool checksumming_active =
         battle_start_frame >= 0 && frame >= battle_start_frame + BATTLE_SETTLE_FRAMES;
 
-    // BACKUP the current (forward) state in this slot before overwriting it,
-    // so we can dump it if a desync is detected.
-    static State forward_backup;
-    bool has_forward_backup = false;
-    if (frame > -1) {
-        int idx = frame % STATE_BUFFER_MAX;
-        if (idx < 0) idx += STATE_BUFFER_MAX;
-        SDL_memcpy(&forward_backup, &state_buffer[idx], sizeof(State));
-        has_forward_backup = true;
-    }
-
-    note_state(dst, frame); // Backup current state to buffer
-
-    // Sanitize ONLY non-functional data in dst (safe for rollback restore):
-    // - Inactive effect slots: zero everything (be_flag == 0 means unused)
-    // - Padding arrays: wrd_free, et_free (never read by game logic)
-    // - WORK_Other_CONN unused tail entries (beyond num_of_conn)
-    // IMPORTANT: Do NOT zero pointer fields in dst — Gekko loads this state
-    // on rollback, and NULL pointers would crash the game immediately.
-    {
-        EffectState* es = &dst->es;
-        for (int i = 0; i < EFFECT_MAX; i++) {
-            WORK* w = (WORK*)es->frw[i];
-            if (w->be_flag == 0) {
-                // Slot unused — zero everything except linked-list pointers
-                // (before/behind/myself) which the effect system needs intact.
-                s16 before = w->before;
-                s16 behind = w->behind;
-                s16 myself = w->myself;
-                SDL_memset(es->frw[i], 0, sizeof(es->frw[i]));
-                w->before = before;
-                w->behind = behind;
-                w->myself = myself;
-            } else {
-                // Active slot: zero only padding (safe for rollback)
-                SDL_zeroa(w->wrd_free);
-
-                WORK_Other* wo = (WORK_Other*)w;
-                SDL_zeroa(wo->et_free);
-
-                if (is_work_other_conn(w->id)) {
-                    sanitize_work_other_conn(w);
-                }
-            }
-        }
-
-        note_state(dst, frame);
-    }
+    sanitize_state(dst);
 
     if (checksumming_active) {
-        // Pointer fields (PLW pointers, WORK pointers, WORK_Other.my_master)
-        // differ between processes because each has its own address space.
-        // Sanitize a COPY for checksumming — never modify dst.
-        static State checksum_scratch;
-        SDL_memcpy(&checksum_scratch, dst, sizeof(State));
-
-        // Zero PLW pointers in the copy
-        sanitize_plw_pointers(&checksum_scratch.gs.plw[0]);
-        sanitize_plw_pointers(&checksum_scratch.gs.plw[1]);
-
-        // Zero EffectState WORK/WORK_Other pointers in the copy
-        EffectState* es = &checksum_scratch.es;
-        for (int i = 0; i < EFFECT_MAX; i++) {
-            WORK* w = (WORK*)es->frw[i];
-            if (w->be_flag != 0) {
-                sanitize_work_pointers(w);
-                sanitize_work_rendering(w);
-                // WORK_Other variants all have my_master right after WORK
-                WORK_Other* wo = (WORK_Other*)w;
-                wo->my_master = NULL;
-            }
-        }
-
-        // Zero GameState pointer fields that differ due to ASLR
-        checksum_scratch.gs.ci_pointer = NULL;
-        for (int i = 0; i < SDL_arraysize(checksum_scratch.gs.task); i++) {
-            checksum_scratch.gs.task[i].func_adrs = NULL;
-        }
-
-        // Zero viewport/resolution-dependent background rendering state
-        // (bg_pos, bg_prm, BgMATRIX differ between peers due to window size)
-        SDL_zeroa(checksum_scratch.gs.bg_pos);
-        SDL_zeroa(checksum_scratch.gs.bg_prm);
-        SDL_zeroa(checksum_scratch.gs.BgMATRIX);
-
-        SectionedChecksum sc = calculate_sectioned_checksums(&checksum_scratch);
-        *event->data.save.checksum = sc.combined;
-
-        // Track forward fx hash per frame using a ringbuffer.
-        // When rollback replays a frame, compare & dump.
-        enum { FX_RING_SIZE = 32 };
-        static uint32_t fx_ring[FX_RING_SIZE] = {0};
-        static int max_forward_frame = -1;
-
-        if (frame > max_forward_frame) {
-            // Forward simulation: record the fx hash
-            fx_ring[frame % FX_RING_SIZE] = sc.effects;
-            max_forward_frame = frame;
-        } else {
-            // Rollback replay: compare with stored forward hash
-            uint32_t fwd = fx_ring[frame % FX_RING_SIZE];
-            bool matches = (sc.effects == fwd);
-            SDL_Log("[P%d F%d] ROLLBACK fx=%08X (fwd=%08X) %s",
-                    local_port, frame, sc.effects, fwd,
-                    matches ? "OK" : "DIVERGED!");
-            if (!matches) {
-                // Dump the ROLLBACK state for offline diff
-                char fname[100];
-                SDL_snprintf(fname, sizeof(fname), "states/rollback_%d_%d", local_port, frame);
-                dump_state(dst, fname);
-                // Also save the forward state from backup
-                if (has_forward_backup) {
-                    SDL_snprintf(fname, sizeof(fname), "states/forward_%d_%d", local_port, frame);
-                    dump_state(&forward_backup, fname);
-                }
-            }
-            // Update the ringbuffer with the rollback hash (GekkoNet uses this one)
-            fx_ring[frame % FX_RING_SIZE] = sc.effects;
-        }
+        publish_checksum_job(dst, frame, event->data.save.checksum);
     }
-#endif
 }
 
 static void load_state(const State* src) {
     // GameState
     const GameState* gs = &src->gs;
     GameState_Load(gs);
+    decode_game_pointers();
 
     // EffectState
-    const EffectState* es = &src->es;
-    SDL_copya(frw, es->frw);
-    SDL_copya(exec_tm, es->exec_tm);
-    SDL_copya(frwque, es->frwque);
-    SDL_copya(head_ix, es->head_ix);
-    SDL_copya(tail_ix, es->tail_ix);
-    frwctr = es->frwctr;
-    frwctr_min = es->frwctr_min;
+    load_effects(state_effects(src));
 }
 
 static void load_state_from_event(GekkoGameEvent* event) {
@@ -597,7 +1052,7 @@ static bool game_ready_to_run_character_select() {
 }
 
 static bool need_to_catch_up() {
-    return frames_behind >= 1;
+    return frames_behind >= CATCH_UP_FRAMES;
 }
 
 static void step_game(bool render) {
@@ -609,10 +1064,7 @@ static void step_game(bool render) {
     seqsAfterProcess();
 }
 
-static void advance_game(GekkoGameEvent* event, bool render) {
-    const u16* inputs = (u16*)event->data.adv.inputs;
-    const int frame = event->data.adv.frame;
-
+static void apply_inputs(const u16* inputs, int frame) {
     p1sw_0 = PLsw[0][0] = inputs[0];
     p2sw_0 = PLsw[1][0] = inputs[1];
     p1sw_1 = PLsw[0][1] = recall_input(0, frame - 1);
@@ -620,21 +1072,220 @@ static void advance_game(GekkoGameEvent* event, bool render) {
 
     note_input(inputs[0], 0, frame);
     note_input(inputs[1], 1, frame);
+}
 
+static void advance_game(GekkoGameEvent* event, bool render) {
+    apply_inputs((u16*)event->data.adv.inputs, event->data.adv.frame);
     step_game(render);
 }
 
+static SectionedChecksum sync_test_checksums[STATE_BUFFER_MAX];
+
+static void log_sections(const char* label, const SectionedChecksum* sc) {
+    SDL_Log("  %s: plw0=%016" SDL_PRIx64 " plw1=%016" SDL_PRIx64 " bg=%016" SDL_PRIx64 " tasks=%016" SDL_PRIx64
+            " fx=%016" SDL_PRIx64 " globals=%016" SDL_PRIx64,
+            label, sc->plw0, sc->plw1, sc->bg, sc->tasks, sc->effects, sc->globals);
+}
+
+static void report_sync_test_mismatch(int frame, const SectionedChecksum* expected, const SectionedChecksum* actual,
+                                      const State* resimulated) {
+    SDL_Log("[sync test F%d] checksum mismatch after rolling back %d frames (forward: %016" SDL_PRIx64
+            ", resimulated: %016" SDL_PRIx64 ")",
+            frame, sync_test_frames, expected->combined, actual->combined);
+    log_sections("forward", expected);
+    log_sections("resimulated", actual);
+
+    char filename[100];
+    SDL_snprintf(filename, sizeof(filename), "states/synctest_forward_%d", frame);
+    dump_state(&state_buffer[frame % STATE_BUFFER_MAX], filename);
+    SDL_snprintf(filename, sizeof(filename), "states/synctest_rollback_%d", frame);
+    dump_state(resimulated, filename);
+}
+
+/// Save the current state as the forward result of `frame`.
+static void save_sync_test_state(int frame) {
+    static State scratch;
+    State* dst = &state_buffer[frame % STATE_BUFFER_MAX];
+    gather_state(dst);
+    sanitize_state(dst);
+
+    // The saved state gets loaded again, so checksum a copy of it
+    SDL_memcpy(&scratch, dst, state_size(dst));
+    sync_test_checksums[frame % STATE_BUFFER_MAX] = checksum_state(&scratch);
+}
+
+/// Roll back to `first_frame` and resimulate up to `last_frame` with the recorded inputs.
+/// @return `false` if any resimulated frame doesn't match its forward checksum.
+static bool resimulate_sync_test(int first_frame, int last_frame) {
+    static State resimulated;
+
+    load_state(&state_buffer[first_frame % STATE_BUFFER_MAX]);
+
+    for (int frame = first_frame + 1; frame <= last_frame; frame++) {
+        const u16 inputs[2] = { recall_input(0, frame), recall_input(1, frame) };
+        apply_inputs(inputs, frame);
+        step_game(false);
+
+        // Same rule as desync detection: the menu-to-battle transition is not checked
+        if (G_No[1] != 2) {
+            continue;
+        }
+
+        gather_state(&resimulated);
+        sanitize_state(&resimulated);
+
+        const SectionedChecksum actual = checksum_state(&resimulated);
+        const SectionedChecksum* expected = &sync_test_checksums[frame % STATE_BUFFER_MAX];
+
+        if (actual.combined != expected->combined) {
+            report_sync_test_mismatch(frame, expected, &actual, &resimulated);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @return The next input of `player`. Each one is held for a random number of frames,
+/// so that moves that take several frames of input come out now and then.
+static u16 random_sync_test_input(int player) {
+    static const u16 directions[] = { 0,
+                                      SWK_UP,
+                                      SWK_DOWN,
+                                      SWK_LEFT,
+                                      SWK_RIGHT,
+                                      SWK_UP | SWK_LEFT,
+                                      SWK_UP | SWK_RIGHT,
+                                      SWK_DOWN | SWK_LEFT,
+                                      SWK_DOWN | SWK_RIGHT };
+
+    if (sync_test_hold[player] > 0) {
+        sync_test_hold[player] -= 1;
+        return sync_test_inputs[player];
+    }
+
+    u16 input = directions[SDL_rand_r(&sync_test_rng, SDL_arraysize(directions))];
+
+    if (SDL_rand_r(&sync_test_rng, 2) == 0) {
+        input |= SWK_WEST << SDL_rand_r(&sync_test_rng, 8);
+    }
+
+    sync_test_inputs[player] = input;
+    sync_test_hold[player] = SDL_rand_r(&sync_test_rng, SYNC_TEST_HOLD_FRAMES_MAX);
+    return input;
+}
+
+static void finish_sync_test(int exit_status) {
+    sync_test_exit_status = exit_status;
+    session_state = SESSION_EXITING;
+}
+
+/// Press and release Start until the main menu shows up, then pick Network like the menu does.
+static void boot_sync_test() {
+    static int boot_frame = 0;
+
+    p1sw_0 = ((boot_frame / SYNC_TEST_START_PULSE_FRAMES) % 2) ? SWK_START : 0;
+    boot_frame += 1;
+    step_game(true);
+
+    if ((G_No[0] == 2) && (G_No[1] == 12)) {
+        sync_test_started = true;
+        Netplay_Begin();
+    }
+}
+
+/// Advance one frame with random inputs, then roll back `sync_test_frames` frames
+/// and check that resimulating them gives the same result.
+static void run_sync_test() {
+    const int frame = sync_test_frame;
+    const u16 inputs[2] = { random_sync_test_input(0), random_sync_test_input(1) };
+
+    apply_inputs(inputs, frame);
+    step_game(true);
+    save_sync_test_state(frame);
+    sync_test_frame += 1;
+
+    if (frame < sync_test_frames) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+
+    if (!resimulate_sync_test(frame - sync_test_frames, frame)) {
+        finish_sync_test(1);
+        return;
+    }
+
+    sync_test_rollback_ns += SDL_GetTicksNS() - start;
+    sync_test_rollbacks += 1;
+
+    if (sync_test_rollbacks >= SYNC_TEST_REPORT_INTERVAL) {
+        SDL_Log("[sync test F%d] OK, %.3f ms per %d-frame rollback",
+                frame, (double)sync_test_rollback_ns / sync_test_rollbacks / 1e6, sync_test_frames);
+        sync_test_rollback_ns = 0;
+        sync_test_rollbacks = 0;
+    }
+
+    if (sync_test_frame >= sync_test_frame_count) {
+        SDL_Log("[sync test] passed, %d frames without a mismatch", sync_test_frame);
+        finish_sync_test(0);
+    }
+}
+
+/// Pick the input delay that hides the one-way latency rollback shouldn't have to cover.
+static void update_input_delay(TimeSync* ts) {
+    if (ts->input_delay_timer > 0) {
+        ts->input_delay_timer -= 1;
+        return;
+    }
+
+    const double latency_frames = (ts->stats.avg_ping / 2 + ts->stats.jitter) / FRAME_TIME_MS;
+    const int target = SDL_clamp((int)SDL_ceil(latency_frames) - ROLLBACK_BUDGET_FRAMES, 0, INPUT_DELAY_MAX);
+
+    if (target == ts->input_delay) {
+        return;
+    }
+
+    // One frame at a time, so that the change is hardly noticeable
+    ts->input_delay += (target > ts->input_delay) ? 1 : -1;
+    ts->input_delay_timer = INPUT_DELAY_INTERVAL;
+    gekko_set_local_delay(session, player_handle, ts->input_delay);
+
+    printf("🛜 input delay %d (avg ping: %.2f, jitter: %.2f)\n", ts->input_delay, ts->stats.avg_ping, ts->stats.jitter);
+}
+
+/// Keep both peers' clocks together by making frames slightly longer when we're ahead
+/// and slightly shorter when we're behind. A peer that runs ahead receives the remote
+/// inputs late and keeps rolling back, while skipping frames to catch up is visible.
+static void update_time_sync() {
+    TimeSync* ts = &time_sync;
+
+    ts->frames_ahead += (gekko_frames_ahead(session) - ts->frames_ahead) * TIME_SYNC_SMOOTHING;
+
+    const double adjustment =
+        SDL_clamp(ts->frames_ahead * TIME_SYNC_GAIN, -TIME_SYNC_MAX_ADJUSTMENT, TIME_SYNC_MAX_ADJUSTMENT);
+    SDLApp_SetFrameTimeScale(1.0 + adjustment);
+
+    gekko_network_stats(session, (player_handle == 0) ? 1 : 0, &ts->stats);
+    update_input_delay(ts);
+}
+
 static void process_session() {
-    frames_behind = -gekko_frames_ahead(session);
+    // Checksums of the last update's saves have to be in place before GekkoNet looks at them
+    flush_checksum_pipeline();
 
     gekko_network_poll(session);
 
-    // GekkoNetworkStats stats;
-    // gekko_network_stats(session, (player_handle == 0) ? 1 : 0, &stats);
-    // printf("🛜 ping: %hu, avg ping: %.2f, jitter: %.2f\n", stats.last_ping, stats.avg_ping, stats.jitter);
+    if (role == ROLE_PLAYER) {
+        frames_behind = -gekko_frames_ahead(session);
 
-    u16 local_inputs = get_inputs();
-    gekko_add_local_input(session, player_handle, &local_inputs);
+        if (session_state == SESSION_RUNNING) {
+            update_time_sync();
+        }
+
+        u16 local_inputs = get_inputs();
+        gekko_add_local_input(session, player_handle, &local_inputs);
+    }
 
     int session_event_count = 0;
     GekkoSessionEvent** session_events = gekko_session_events(session, &session_event_count);
@@ -671,8 +1322,7 @@ static void process_session() {
             // Log per-section checksums to help narrow down the diverging subsystem
             const State* saved = &state_buffer[frame % STATE_BUFFER_MAX];
             SectionedChecksum sc = calculate_sectioned_checksums(saved);
-            printf("  sections: plw0=0x%08x plw1=0x%08x bg=0x%08x tasks=0x%08x fx=0x%08x globals=0x%08x\n",
-                   sc.plw0, sc.plw1, sc.bg, sc.tasks, sc.effects, sc.globals);
+            log_sections("sections", &sc);
             dump_saved_state(frame);
 #endif
 
@@ -682,9 +1332,15 @@ static void process_session() {
             break;
         }
 
-        case EmptySessionEvent:
         case SpectatorPaused:
+            printf("🔴 spectator paused, waiting for inputs\n");
+            break;
+
         case SpectatorUnpaused:
+            printf("🔴 spectator unpaused\n");
+            break;
+
+        case EmptySessionEvent:
             // Do nothing
             break;
         }
@@ -694,21 +1350,62 @@ static void process_session() {
 static void process_events(bool drawing_allowed) {
     int game_event_count = 0;
     GekkoGameEvent** game_events = gekko_update_session(session, &game_event_count);
+    int last_advance = -1;
+
+    for (int i = 0; i < game_event_count; i++) {
+        if (game_events[i]->type == AdvanceEvent) {
+            last_advance = i;
+        }
+    }
 
     for (int i = 0; i < game_event_count; i++) {
         const GekkoGameEvent* event = game_events[i];
 
+        const Uint64 start = SDL_GetTicksNS();
+
         switch (event->type) {
         case LoadEvent:
             load_state_from_event(event);
+            Telemetry_NoteTime(TELEMETRY_LOAD, SDL_GetTicksNS() - start);
+            Telemetry_NoteRollback(next_frame - event->data.load.frame);
+            next_frame = event->data.load.frame;
             break;
 
-        case AdvanceEvent:
-            advance_game(event, drawing_allowed && !event->data.adv.rolling_back);
+        case AdvanceEvent: {
+            bool render = drawing_allowed && !event->data.adv.rolling_back;
+
+            if (role == ROLE_SPECTATOR) {
+                // Without the frames before it, a spectator would simulate them on the wrong
+                // state, and there's no state transfer to make up for them
+                if (!Relay_PushInputs(event->data.adv.frame, (u16*)event->data.adv.inputs)) {
+                    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING,
+                                             "Netplay",
+                                             "The session started before this spectator connected. Spectators "
+                                             "have to connect before the session starts, viewers can join any time.",
+                                             NULL);
+                    session_state = SESSION_EXITING;
+                    return;
+                }
+
+                // Spectators only get confirmed frames. Several of them can arrive at once,
+                // only the newest is drawn.
+                render = drawing_allowed && (i == last_advance);
+            }
+
+            advance_game(event, render);
+            Telemetry_NoteTime(render ? TELEMETRY_ADVANCE_RENDERED : TELEMETRY_ADVANCE, SDL_GetTicksNS() - start);
+
+            if (event->data.adv.rolling_back) {
+                Telemetry_NoteResimulatedFrame();
+            }
+
+            next_frame = event->data.adv.frame + 1;
             break;
+        }
 
         case SaveEvent:
             save_state(event);
+            Telemetry_NoteTime(TELEMETRY_SAVE, SDL_GetTicksNS() - start);
             break;
 
         case EmptyGameEvent:
@@ -723,22 +1420,176 @@ static void step_logic(bool drawing_allowed) {
     process_events(drawing_allowed);
 }
 
+static void run_viewer() {
+    static bool buffering = true;
+
+    RelayViewer_Update();
+
+    // Wait until a few frames are in hand before playing, so that jitter doesn't stall
+    // every other frame. Fast-forward without drawing when far behind, e.g. after joining late.
+    const int available = RelayViewer_FramesAvailable();
+    int steps = 1;
+
+    if (available == 0) {
+        buffering = true;
+    } else if (available >= VIEWER_BUFFER_FRAMES) {
+        buffering = false;
+    }
+
+    if (buffering) {
+        return;
+    }
+
+    if (available > VIEWER_BUFFER_FRAMES * 2) {
+        steps = SDL_min(available - VIEWER_BUFFER_FRAMES, VIEWER_CATCH_UP_MAX);
+    }
+
+    for (int i = 0; i < steps; i++) {
+        int frame;
+        u16 inputs[2];
+        RelayViewer_TakeInputs(&frame, inputs);
+        apply_inputs(inputs, frame);
+        step_game(i == steps - 1);
+    }
+}
+
 static void run_netplay() {
-    const bool catch_up = need_to_catch_up() && (frame_skip_timer == 0);
+    // Small differences are evened out by time sync. Only large ones, e.g. after a hitch,
+    // are worth skipping frames for.
+    const bool catch_up = need_to_catch_up();
     step_logic(!catch_up);
 
     if (catch_up) {
         step_logic(true);
-        frame_skip_timer = 60; // Allow skipping a frame roughly every second
     }
 
-    frame_skip_timer -= 1;
+    if (session_state != SESSION_RUNNING) {
+        return;
+    }
+
+    Telemetry_EndFrame(frames_behind);
 
-    if (frame_skip_timer < 0) {
-        frame_skip_timer = 0;
+    if (net_emulation_enabled) {
+        net_emulation_report_timer += 1;
+
+        if (net_emulation_report_timer == NET_EMULATION_REPORT_FRAMES) {
+            NetEmulator_Report();
+            Telemetry_LogSummary();
+            net_emulation_report_timer = 0;
+        }
     }
 }
 
+static bool can_run_ahead() {
+    // Only battles are run ahead. Hidden frames elsewhere, e.g. in character select, could start file loads
+    return (run_ahead_frames > 0) && (G_No[1] == 2) &&
+           ((Mode_Type == MODE_VERSUS) || (Mode_Type == MODE_NORMAL_TRAINING) || (Mode_Type == MODE_PARRY_TRAINING));
+}
+
+static void note_run_ahead(const RunAheadStats* frame) {
+    RunAheadStats* s = &run_ahead_stats;
+    const Uint64 total_ns = frame->step_ns + frame->save_ns + frame->hidden_ns + frame->load_ns;
+
+    s->frames += 1;
+    s->step_ns += frame->step_ns;
+    s->save_ns += frame->save_ns;
+    s->hidden_ns += frame->hidden_ns;
+    s->load_ns += frame->load_ns;
+    s->total_max_ns = SDL_max(s->total_max_ns, total_ns);
+
+    if (s->frames < RUN_AHEAD_STATS_FRAMES) {
+        return;
+    }
+
+    const double frames = s->frames * 1e6;
+    const double total_ms = (s->step_ns + s->save_ns + s->hidden_ns + s->load_ns) / frames;
+
+    SDL_snprintf(run_ahead_overlay,
+                 sizeof(run_ahead_overlay),
+                 "Run-ahead %d | step %.2f save %.2f ahead %.2f load %.2f ms | total %.2f, max %.2f of %.2f ms",
+                 run_ahead_frames,
+                 s->step_ns / frames,
+                 s->save_ns / frames,
+                 s->hidden_ns / frames,
+                 s->load_ns / frames,
+                 total_ms,
+                 s->total_max_ns / 1e6,
+                 FRAME_TIME_MS);
+
+    has_run_ahead_overlay = true;
+    run_ahead_report_timer += s->frames;
+
+    if (run_ahead_report_timer >= RUN_AHEAD_REPORT_FRAMES) {
+        SDL_Log("[run-ahead] %d frames ahead: %.2f ms per frame on average, %.2f ms at most, %.2f ms per frame "
+                "simulated ahead (budget %.2f ms)",
+                run_ahead_frames,
+                total_ms,
+                s->total_max_ns / 1e6,
+                s->hidden_ns / frames / run_ahead_frames,
+                FRAME_TIME_MS);
+        run_ahead_report_timer = 0;
+    }
+
+    SDL_zerop(s);
+}
+
+/// Simulate the real frame without drawing it, then simulate `run_ahead_frames` more with the same
+/// inputs, draw the last of them and go back to the real frame. What's on screen is then
+/// `run_ahead_frames` frames further along than what the inputs have reached.
+static void run_ahead() {
+    const u16 sw[4] = { p1sw_0, p2sw_0, p3sw_0, p4sw_0 };
+    const u16 pl_sw[2] = { PLsw[0][0], PLsw[1][0] };
+    RunAheadStats frame = { 0 };
+    Uint64 start = SDL_GetTicksNS();
+    Uint64 now;
+
+    // Sounds are made by this frame only, frames simulated ahead are replayed for real later
+    step_game(false);
+    now = SDL_GetTicksNS();
+    frame.step_ns = now - start;
+    start = now;
+
+    // Inputs live outside of the game state. Keep what the real frame left in them for the next one.
+    const u16 sw_after[4][2] = {
+        { p1sw_0, p1sw_1 }, { p2sw_0, p2sw_1 }, { p3sw_0, p3sw_1 }, { p4sw_0, p4sw_1 }
+    };
+
+    gather_state(&run_ahead_state);
+    now = SDL_GetTicksNS();
+    frame.save_ns = now - start;
+    start = now;
+
+    sound_requests_muted = true;
+
+    for (int i = 0; i < run_ahead_frames; i++) {
+        p1sw_1 = p1sw_0 = sw[0];
+        p2sw_1 = p2sw_0 = sw[1];
+        p3sw_1 = p3sw_0 = sw[2];
+        p4sw_1 = p4sw_0 = sw[3];
+        PLsw[0][1] = PLsw[0][0] = pl_sw[0];
+        PLsw[1][1] = PLsw[1][0] = pl_sw[1];
+        step_game(i == run_ahead_frames - 1);
+    }
+
+    sound_requests_muted = false;
+    now = SDL_GetTicksNS();
+    frame.hidden_ns = now - start;
+    start = now;
+
+    load_state(&run_ahead_state);
+    p1sw_0 = sw_after[0][0];
+    p1sw_1 = sw_after[0][1];
+    p2sw_0 = sw_after[1][0];
+    p2sw_1 = sw_after[1][1];
+    p3sw_0 = sw_after[2][0];
+    p3sw_1 = sw_after[2][1];
+    p4sw_0 = sw_after[3][0];
+    p4sw_1 = sw_after[3][1];
+    frame.load_ns = SDL_GetTicksNS() - start;
+
+    note_run_ahead(&frame);
+}
+
 void Netplay_SetParams(int player, const char* ip) {
     SDL_assert(player == 1 || player == 2);
     player_number = player - 1;
@@ -762,6 +1613,71 @@ void Netplay_SetParams(int player, const char* ip) {
     }
 }
 
+void Netplay_SetNetworkEmulation(const char* spec) {
+    net_emulation_enabled = NetEmulator_Parse(spec, &net_emulation);
+
+    if (!net_emulation_enabled) {
+        SDL_Log("Invalid network emulation settings \"%s\"", spec);
+    }
+}
+
+void Netplay_SetTelemetryFile(const char* path) {
+    telemetry_path = path;
+}
+
+const char* Netplay_GetTelemetryOverlay() {
+    return (session_state == SESSION_RUNNING) ? Telemetry_GetOverlayText() : NULL;
+}
+
+void Netplay_SetRunAhead(int frames) {
+    run_ahead_frames = SDL_clamp(frames, 0, RUN_AHEAD_MAX);
+}
+
+const char* Netplay_GetRunAheadOverlay() {
+    return (is_running_ahead && has_run_ahead_overlay) ? run_ahead_overlay : NULL;
+}
+
+void Netplay_AddSpectator(const char* ip) {
+    if (spectator_count == SPECTATOR_MAX) {
+        SDL_Log("Only %d spectators are supported, ignoring %s", SPECTATOR_MAX, ip);
+        return;
+    }
+
+    spectator_ips[spectator_count] = ip;
+    spectator_count += 1;
+}
+
+void Netplay_SetSpectate(const char* ip) {
+    role = ROLE_SPECTATOR;
+    remote_ip = ip;
+    local_port = SPECTATOR_PORT;
+    remote_port = 50000; // Spectators watch player 1
+}
+
+void Netplay_SetWatch(const char* ip) {
+    role = ROLE_VIEWER;
+    remote_ip = ip;
+    local_port = RELAY_VIEWER_PORT;
+}
+
+void Netplay_SetDesyncDetection(bool enabled) {
+    desync_detection = enabled;
+}
+
+void Netplay_SetSyncTest(int frames, int frame_count, uint64_t seed) {
+    sync_test_frames = SDL_clamp(frames, 1, STATE_BUFFER_MAX - 1);
+    sync_test_frame_count = SDL_max(frame_count, 1);
+    sync_test_rng = seed;
+    SDL_Log("Sync test enabled with %d rollback frames for %d frames, seed %" SDL_PRIu64,
+            sync_test_frames,
+            sync_test_frame_count,
+            (Uint64)seed);
+}
+
+int Netplay_GetSyncTestExitStatus() {
+    return (session_state == SESSION_IDLE) ? sync_test_exit_status : -1;
+}
+
 void Netplay_Begin() {
     setup_vs_mode();
     session_state = SESSION_TRANSITIONING;
@@ -773,6 +1689,24 @@ void Netplay_Run() {
         if (!game_ready_to_run_character_select()) {
             step_game(true);
         } else {
+            if (sync_test_frames > 0) {
+                sync_test_frame = 0;
+                session_state = SESSION_SYNC_TEST;
+                break;
+            }
+
+            if (role == ROLE_VIEWER) {
+                char relay_address[100];
+                SDL_snprintf(relay_address, sizeof(relay_address), "%s:%d", remote_ip, SPECTATOR_PORT);
+                RelayViewer_Begin(relay_address, local_port);
+                session_state = SESSION_VIEWING;
+                break;
+            }
+
+            if (desync_detection && (role == ROLE_PLAYER)) {
+                start_checksum_pipeline();
+            }
+
             configure_gekko();
             session_state = SESSION_CONNECTING;
         }
@@ -782,18 +1716,50 @@ void Netplay_Run() {
     case SESSION_CONNECTING:
     case SESSION_RUNNING:
         run_netplay();
+
+        if (role == ROLE_SPECTATOR) {
+            Relay_Update();
+        }
+
+        break;
+
+    case SESSION_VIEWING:
+        run_viewer();
+        break;
+
+    case SESSION_SYNC_TEST:
+        run_sync_test();
         break;
 
     case SESSION_EXITING:
+        stop_checksum_pipeline();
+
+        if ((sync_test_frames > 0) && (sync_test_exit_status < 0)) {
+            SDL_Log("[sync test] the session was left after %d frames without a mismatch", sync_test_frame);
+            sync_test_exit_status = 0;
+        }
+
         if (session != NULL) {
             // cleanup session and then return to idle
             gekko_destroy(&session);
             // also cleanup default socket.
-            #ifndef LOSSY_ADAPTER
             gekko_default_adapter_destroy();
-            #endif
-            
+            NetEmulator_End();
         }
+
+        SDLApp_SetFrameTimeScale(1.0);
+        SDL_zero(time_sync);
+        Telemetry_LogSummary();
+        Telemetry_End();
+        net_emulation_report_timer = 0;
+        next_frame = 0;
+
+        if (role == ROLE_SPECTATOR) {
+            Relay_End();
+        } else if (role == ROLE_VIEWER) {
+            RelayViewer_End();
+        }
+
         session_state = SESSION_IDLE;
         break;
 
@@ -802,6 +1768,27 @@ void Netplay_Run() {
     }
 }
 
+void Netplay_StepOffline() {
+    if ((sync_test_frames > 0) && !sync_test_started) {
+        boot_sync_test();
+        return;
+    }
+
+    const bool was_running_ahead = is_running_ahead;
+    is_running_ahead = can_run_ahead();
+
+    if (is_running_ahead != was_running_ahead) {
+        SDL_zero(run_ahead_stats);
+        has_run_ahead_overlay = false;
+    }
+
+    if (is_running_ahead) {
+        run_ahead();
+    } else {
+        step_game(true);
+    }
+}
+
 bool Netplay_IsRunning() {
     return session_state != SESSION_IDLE;
 }
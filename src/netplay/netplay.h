@@ -2,10 +2,60 @@
 #define NETPLAY_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#define SYNC_TEST_FRAME_COUNT_DEFAULT 18000
 
 void Netplay_SetParams(int player, const char* ip);
+
+/// Send packets through an emulated network, e.g. `latency=60,jitter=8,loss=0.02`.
+/// While it's on, the settings and the session's telemetry summary are logged every 10 seconds.
+/// See `NetEmulator_Parse` for all settings.
+void Netplay_SetNetworkEmulation(const char* spec);
+
+/// Write a row of netplay telemetry to the CSV file at `path` every second.
+void Netplay_SetTelemetryFile(const char* path);
+
+/// @return One line summary of the last second of netplay telemetry,
+/// `NULL` when no session is running.
+const char* Netplay_GetTelemetryOverlay();
+
+/// Simulate `frames` frames ahead of the real one in battles of versus and training modes
+/// to hide that much of the game's input lag, up to 4. `0` turns run-ahead off.
+void Netplay_SetRunAhead(int frames);
+
+/// @return One line summary of how long run-ahead takes per frame,
+/// `NULL` when it isn't running.
+const char* Netplay_GetRunAheadOverlay();
+
+/// Let the spectator at `ip` watch the match. Only player 1 should add spectators.
+void Netplay_AddSpectator(const char* ip);
+
+/// Watch the match of player 1 at `ip`. Viewers can in turn watch through this spectator.
+/// Spectators have to connect before the session starts, late ones are turned away.
+void Netplay_SetSpectate(const char* ip);
+
+/// Watch a match through the spectator at `ip`, joining at any point of the match.
+void Netplay_SetWatch(const char* ip);
+
+/// Exchange state checksums with the remote player and end the session when they differ.
+/// They're computed on a worker thread, so this is on by default.
+void Netplay_SetDesyncDetection(bool enabled);
+
+/// Run an in-process sync test instead of playing: the game goes straight from the title
+/// screen to a versus session, where both players press random inputs drawn from `seed`.
+/// Every frame is rolled back `frames` frames and resimulated without drawing, and the result
+/// is compared against the original run. The test ends at the first mismatch or after `frame_count` frames.
+void Netplay_SetSyncTest(int frames, int frame_count, uint64_t seed);
+
+/// @return `0` once the sync test has passed, `1` once it has failed, `-1` while it's running
+/// or when there's none.
+int Netplay_GetSyncTestExitStatus();
 void Netplay_Begin();
 void Netplay_Run();
+
+/// Step the game when no session is running. Runs ahead when it's enabled and the game allows it.
+void Netplay_StepOffline();
 bool Netplay_IsRunning();
 void Netplay_HandleMenuExit();
 
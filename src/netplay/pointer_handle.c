@@ -0,0 +1,273 @@
+#include "netplay/pointer_handle.h"
+#include "common.h"
+#include "sf33rd/AcrSDK/ps2/foundaps2.h"
+
+#include <SDL3/SDL.h>
+
+#if defined(__APPLE__)
+#include <mach-o/loader.h>
+#endif
+
+#define PH_REGION_BITS 2
+#define PH_OFFSET_BITS (sizeof(PointerHandle) * 8 - PH_REGION_BITS)
+#define PH_OFFSET_MASK (((PointerHandle)1 << PH_OFFSET_BITS) - 1)
+#define PH_UNKNOWN ((PointerHandle)REGION_UNKNOWN << PH_OFFSET_BITS)
+
+#define EFFECT_ID_COUNT 229 // Entries of effmovejptbl
+#define UNKNOWN_POINTER_LOG_MAX 16
+
+typedef enum PointerRegion {
+    REGION_NULL,
+    REGION_IMAGE,   // Code, tables and globals of the executable
+    REGION_FMS,     // Data loaded from the AFS, allocated from flFMS
+    REGION_UNKNOWN, // Anything else, like stale or heap pointers. Decodes to NULL.
+} PointerRegion;
+
+// Load address of the executable, provided by the linker
+#if defined(__APPLE__)
+extern const struct mach_header_64 image_header __asm("__mh_execute_header");
+#define image_base ((const u8*)&image_header)
+#elif defined(_WIN32)
+extern const u8 __ImageBase[];
+#define image_base __ImageBase
+#else
+extern const u8 __executable_start[];
+extern const u8 _end[]; // End of .bss
+#define image_base __executable_start
+#endif
+
+/// @return End of the executable image: its code, data and bss.
+static const u8* image_end() {
+    static const u8* end = NULL;
+
+    if (end != NULL) {
+        return end;
+    }
+
+#if defined(__APPLE__)
+    // Segments are mapped at the same distance from each other as in the file
+    const u8* cmd = (const u8*)(&image_header + 1);
+    uint64_t text_vmaddr = 0;
+    uint64_t vm_end = 0;
+
+    for (uint32_t i = 0; i < image_header.ncmds; i++) {
+        const struct segment_command_64* segment = (const struct segment_command_64*)cmd;
+
+        if ((segment->cmd == LC_SEGMENT_64) && (SDL_strcmp(segment->segname, SEG_PAGEZERO) != 0)) {
+            if (SDL_strcmp(segment->segname, SEG_TEXT) == 0) {
+                text_vmaddr = segment->vmaddr;
+            }
+
+            vm_end = SDL_max(vm_end, segment->vmaddr + segment->vmsize);
+        }
+
+        cmd += segment->cmdsize;
+    }
+
+    end = image_base + (vm_end - text_vmaddr);
+#elif defined(_WIN32)
+    // IMAGE_DOS_HEADER::e_lfanew, then IMAGE_NT_HEADERS::OptionalHeader.SizeOfImage,
+    // which is at the same offset in 32 and 64-bit images. windows.h clashes with structs.h.
+    Uint32 nt_headers_offset;
+    Uint32 size_of_image;
+
+    SDL_memcpy(&nt_headers_offset, image_base + 0x3C, sizeof(nt_headers_offset));
+    SDL_memcpy(&size_of_image, image_base + nt_headers_offset + 4 + 20 + 56, sizeof(size_of_image));
+    end = image_base + size_of_image;
+#else
+    end = _end;
+#endif
+
+    return end;
+}
+
+static PointerHandle encode_pointer(const void* ptr, const char* name) {
+    const u8* p = ptr;
+    const u8* fms_begin = flFMS.baseandcap[0];
+    const u8* fms_end = flFMS.baseandcap[1];
+    PointerRegion region;
+    uintptr_t offset;
+
+    if (p == NULL) {
+        return 0;
+    }
+
+    if ((fms_begin != NULL) && (p >= fms_begin) && (p < fms_end)) {
+        region = REGION_FMS;
+        offset = p - fms_begin;
+    } else if ((p >= image_base) && (p < image_end())) {
+        region = REGION_IMAGE;
+        offset = p - image_base;
+    } else {
+        // Anything else, like the heap or a stale value, is at a different address in every
+        // process, so they're all saved alike and restored as NULL
+#if defined(DEBUG)
+        static int logged = 0;
+
+        if (logged < UNKNOWN_POINTER_LOG_MAX) {
+            SDL_Log("[pointer handle] %s = %p is outside the executable and flFMS, saved as unknown", name, ptr);
+            logged += 1;
+        }
+#endif
+
+        return PH_UNKNOWN;
+    }
+
+    if (offset > PH_OFFSET_MASK) {
+        fatal_error("Pointer %p can't be turned into a handle", ptr);
+    }
+
+    return ((PointerHandle)region << PH_OFFSET_BITS) | offset;
+}
+
+PointerHandle PointerHandle_Encode(const void* ptr) {
+    return encode_pointer(ptr, "pointer");
+}
+
+void* PointerHandle_Decode(PointerHandle handle) {
+    const uintptr_t offset = handle & PH_OFFSET_MASK;
+    const u8* fms_begin = flFMS.baseandcap[0];
+    const u8* fms_end = flFMS.baseandcap[1];
+
+    switch (handle >> PH_OFFSET_BITS) {
+    case REGION_NULL:
+        if (offset == 0) {
+            return NULL;
+        }
+
+        break;
+
+    case REGION_IMAGE:
+        if (offset < (uintptr_t)(image_end() - image_base)) {
+            return (void*)(image_base + offset);
+        }
+
+        break;
+
+    case REGION_FMS:
+        if ((fms_begin != NULL) && (offset < (uintptr_t)(fms_end - fms_begin))) {
+            return (void*)(fms_begin + offset);
+        }
+
+        break;
+
+    case REGION_UNKNOWN:
+        if (offset == 0) {
+            return NULL;
+        }
+
+        break;
+    }
+
+    fatal_error("Invalid pointer handle %" SDL_PRIx64, (Uint64)handle);
+}
+
+// Pointers are swapped for handles of the same size, so these work on the raw bytes
+// of any pointer field, function pointers included.
+
+static void encode(void* field, const char* name) {
+    void* ptr;
+    SDL_memcpy(&ptr, field, sizeof(ptr));
+    const PointerHandle handle = encode_pointer(ptr, name);
+    SDL_memcpy(field, &handle, sizeof(handle));
+}
+
+static void decode(void* field) {
+    PointerHandle handle;
+    SDL_memcpy(&handle, field, sizeof(handle));
+    void* ptr = PointerHandle_Decode(handle);
+    SDL_memcpy(field, &ptr, sizeof(ptr));
+}
+
+#define WORK_POINTERS(X)                                                                                               \
+    X(target_adrs)                                                                                                     \
+    X(hit_adrs)                                                                                                        \
+    X(dmg_adrs)                                                                                                        \
+    X(suzi_offset)                                                                                                     \
+    X(se_random_table)                                                                                                 \
+    X(step_xy_table)                                                                                                   \
+    X(move_xy_table)                                                                                                   \
+    X(overlap_char_tbl)                                                                                                \
+    X(olc_ix_table)                                                                                                    \
+    X(rival_catch_tbl)                                                                                                 \
+    X(curr_rca)                                                                                                        \
+    X(set_char_ad)                                                                                                     \
+    X(hit_ix_table)                                                                                                    \
+    X(body_adrs)                                                                                                       \
+    X(h_bod)                                                                                                           \
+    X(hand_adrs)                                                                                                       \
+    X(h_han)                                                                                                           \
+    X(dumm_adrs)                                                                                                       \
+    X(h_dumm)                                                                                                          \
+    X(catch_adrs)                                                                                                      \
+    X(h_cat)                                                                                                           \
+    X(caught_adrs)                                                                                                     \
+    X(h_cau)                                                                                                           \
+    X(attack_adrs)                                                                                                     \
+    X(h_att)                                                                                                           \
+    X(h_eat)                                                                                                           \
+    X(hosei_adrs)                                                                                                      \
+    X(h_hos)                                                                                                           \
+    X(att_ix_table)                                                                                                    \
+    X(my_effadrs)
+
+#define PLW_POINTERS(X)                                                                                                \
+    X(cp)                                                                                                              \
+    X(dm_step_tbl)                                                                                                     \
+    X(as)                                                                                                              \
+    X(sa)                                                                                                              \
+    X(py)
+
+#define ENCODE(field) encode(&w->field, #field);
+#define DECODE(field) decode(&w->field);
+
+static void encode_work(WORK* w) {
+    WORK_POINTERS(ENCODE)
+
+    for (int i = 0; i < SDL_arraysize(w->char_table); i++) {
+        encode(&w->char_table[i], "char_table");
+    }
+}
+
+static void decode_work(WORK* w) {
+    WORK_POINTERS(DECODE)
+
+    for (int i = 0; i < SDL_arraysize(w->char_table); i++) {
+        decode(&w->char_table[i]);
+    }
+}
+
+void PointerHandle_EncodePlayer(PLW* w) {
+    encode_work(&w->wu);
+    PLW_POINTERS(ENCODE)
+}
+
+void PointerHandle_DecodePlayer(PLW* w) {
+    decode_work(&w->wu);
+    PLW_POINTERS(DECODE)
+}
+
+// Every effect in effmovejptbl runs on one of these, and they all have my_master in the same place
+SDL_COMPILE_TIME_ASSERT(conn_my_master, offsetof(WORK_Other_CONN, my_master) == offsetof(WORK_Other, my_master));
+SDL_COMPILE_TIME_ASSERT(judge_my_master, offsetof(WORK_Other_JUDGE, my_master) == offsetof(WORK_Other, my_master));
+
+/// @return `true` if the slot holds an effect, so that it's one of the `WORK_Other` variants.
+static bool has_master(const WORK_Other* w) {
+    return (w->wu.id >= 0) && (w->wu.id < EFFECT_ID_COUNT);
+}
+
+void PointerHandle_EncodeEffect(WORK_Other* w) {
+    encode_work(&w->wu);
+
+    if (has_master(w)) {
+        encode(&w->my_master, "my_master");
+    }
+}
+
+void PointerHandle_DecodeEffect(WORK_Other* w) {
+    decode_work(&w->wu);
+
+    if (has_master(w)) {
+        decode(&w->my_master);
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef NETPLAY_POINTER_HANDLE_H
+#define NETPLAY_POINTER_HANDLE_H
+
+#include "structs.h"
+
+#include <stdint.h>
+
+/// Position-independent stand-in for a pointer inside a snapshot.
+///
+/// The top bits name the region the pointer points into (the executable image or
+/// the game's memory block), the rest is the offset into that region. `0` is `NULL`.
+/// Pointers outside both regions all get the same "unknown" handle, which decodes to `NULL`.
+/// Handles have the same value in every process running the same build, so snapshots
+/// that only contain handles can be hashed as they are and sent to other processes.
+typedef uintptr_t PointerHandle;
+
+PointerHandle PointerHandle_Encode(const void* ptr);
+void* PointerHandle_Decode(PointerHandle handle);
+
+/// Turn the pointers of a player into handles in place.
+void PointerHandle_EncodePlayer(PLW* p);
+void PointerHandle_DecodePlayer(PLW* p);
+
+/// Turn the pointers of an effect pool slot into handles in place. `my_master` is only
+/// converted for slots whose effect id is in range, the others are only known to be `WORK`.
+void PointerHandle_EncodeEffect(WORK_Other* w);
+void PointerHandle_DecodeEffect(WORK_Other* w);
+
+#endif
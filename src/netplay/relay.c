@@ -0,0 +1,352 @@
+#include "netplay/relay.h"
+#include "common.h"
+
+#include <SDL3/SDL.h>
+
+#define RELAY_VIEWER_MAX 16
+#define RELAY_ADDRESS_MAX 64
+#define RELAY_FRAMES_PER_PACKET 240
+#define RELAY_PACKETS_PER_UPDATE 4 // Per viewer, lets late joiners download the log quickly
+#define RELAY_RESEND_MS 500        // Resend from the last acknowledged frame after this long
+#define RELAY_TIMEOUT_MS 5000
+
+// Packets start with a tag, so that they can share a socket with GekkoNet
+static const u8 relay_tag[4] = { '3', 'S', 'X', 'R' };
+
+typedef enum RelayPacketType {
+    PACKET_HELLO,  // Viewer -> relay: u32 frames received so far
+    PACKET_INPUTS, // Relay -> viewer: u32 first frame, u16 frame count, u16 inputs[count][2]
+} RelayPacketType;
+
+#define RELAY_HEADER_SIZE (sizeof(relay_tag) + 1)
+#define RELAY_PACKET_MAX (RELAY_HEADER_SIZE + 6 + RELAY_FRAMES_PER_PACKET * 4)
+
+typedef struct RelayAddress {
+    char data[RELAY_ADDRESS_MAX];
+    unsigned int size;
+} RelayAddress;
+
+typedef struct RelayViewer {
+    RelayAddress address;
+    int acked;    // Frames the viewer has received
+    int sent;     // Frames sent to the viewer
+    Uint64 acked_ms;
+    Uint64 heard_ms;
+} RelayViewer;
+
+/// Growable log of every confirmed input of the match.
+typedef struct InputLog {
+    u16 (*inputs)[2];
+    int count;
+    int capacity;
+} InputLog;
+
+typedef struct Relay {
+    GekkoNetAdapter* base;
+    GekkoNetAdapter adapter;
+    GekkoNetResult** passed;
+    int passed_capacity;
+    InputLog log;
+    RelayViewer viewers[RELAY_VIEWER_MAX];
+    int viewer_count;
+} Relay;
+
+typedef struct Viewer {
+    GekkoNetAdapter* adapter;
+    RelayAddress relay;
+    InputLog log;
+    int taken;
+} Viewer;
+
+static Relay relay = { 0 };
+static Viewer viewer = { 0 };
+
+static void write_u16(u8* dst, u16 value) {
+    dst[0] = value & 0xFF;
+    dst[1] = value >> 8;
+}
+
+static void write_u32(u8* dst, u32 value) {
+    write_u16(dst, value & 0xFFFF);
+    write_u16(dst + 2, value >> 16);
+}
+
+static u16 read_u16(const u8* src) {
+    return src[0] | (src[1] << 8);
+}
+
+static u32 read_u32(const u8* src) {
+    return read_u16(src) | ((u32)read_u16(src + 2) << 16);
+}
+
+static u8* write_header(u8* dst, RelayPacketType type) {
+    SDL_memcpy(dst, relay_tag, sizeof(relay_tag));
+    dst[sizeof(relay_tag)] = type;
+    return dst + RELAY_HEADER_SIZE;
+}
+
+static bool is_relay_packet(const GekkoNetResult* result) {
+    return (result->data_len >= RELAY_HEADER_SIZE) &&
+           (SDL_memcmp(result->data, relay_tag, sizeof(relay_tag)) == 0);
+}
+
+/// Free a received packet the same way GekkoNet does.
+static void free_result(GekkoNetAdapter* adapter, GekkoNetResult* result) {
+    adapter->free_data(result->addr.data);
+    adapter->free_data(result->data);
+    adapter->free_data(result);
+}
+
+static void log_push(InputLog* log, const u16* inputs) {
+    if (log->count == log->capacity) {
+        log->capacity = SDL_max(log->capacity * 2, 60 * 60);
+        log->inputs = SDL_realloc(log->inputs, log->capacity * sizeof(log->inputs[0]));
+
+        if (log->inputs == NULL) {
+            fatal_error("Failed to grow the relay input log to %d frames", log->capacity);
+        }
+    }
+
+    log->inputs[log->count][0] = inputs[0];
+    log->inputs[log->count][1] = inputs[1];
+    log->count += 1;
+}
+
+static void log_free(InputLog* log) {
+    SDL_free(log->inputs);
+    SDL_zerop(log);
+}
+
+// Relay
+
+static RelayViewer* find_viewer(const GekkoNetAddress* address) {
+    for (int i = 0; i < relay.viewer_count; i++) {
+        RelayViewer* v = &relay.viewers[i];
+
+        if ((v->address.size == address->size) && (SDL_memcmp(v->address.data, address->data, address->size) == 0)) {
+            return v;
+        }
+    }
+
+    if ((relay.viewer_count == RELAY_VIEWER_MAX) || (address->size > RELAY_ADDRESS_MAX)) {
+        return NULL;
+    }
+
+    RelayViewer* v = &relay.viewers[relay.viewer_count];
+    SDL_zerop(v);
+    SDL_memcpy(v->address.data, address->data, address->size);
+    v->address.size = address->size;
+    v->acked_ms = SDL_GetTicks();
+    relay.viewer_count += 1;
+
+    SDL_Log("[relay] viewer %.*s joined", (int)address->size, (const char*)address->data);
+    return v;
+}
+
+static void handle_hello(const GekkoNetResult* result) {
+    if (result->data_len < RELAY_HEADER_SIZE + 4) {
+        return;
+    }
+
+    RelayViewer* v = find_viewer(&result->addr);
+
+    if (v == NULL) {
+        return;
+    }
+
+    const int acked = read_u32((const u8*)result->data + RELAY_HEADER_SIZE);
+    v->heard_ms = SDL_GetTicks();
+
+    if (acked > v->acked) {
+        v->acked = SDL_min(acked, relay.log.count);
+        v->acked_ms = v->heard_ms;
+    }
+}
+
+static GekkoNetResult** Relay_ReceiveData(int* length) {
+    int count = 0;
+    GekkoNetResult** results = relay.base->receive_data(&count);
+    int passed = 0;
+
+    if (count > relay.passed_capacity) {
+        GekkoNetResult** grown = SDL_realloc(relay.passed, count * sizeof(relay.passed[0]));
+
+        if (grown == NULL) {
+            fatal_error("Failed to grow the relay packet list to %d packets", count);
+        }
+
+        relay.passed = grown;
+        relay.passed_capacity = count;
+    }
+
+    for (int i = 0; i < count; i++) {
+        GekkoNetResult* result = results[i];
+
+        if (!is_relay_packet(result)) {
+            relay.passed[passed++] = result;
+            continue;
+        }
+
+        if (((const u8*)result->data)[sizeof(relay_tag)] == PACKET_HELLO) {
+            handle_hello(result);
+        }
+
+        free_result(relay.base, result);
+    }
+
+    *length = passed;
+    return relay.passed;
+}
+
+GekkoNetAdapter* Relay_Begin(GekkoNetAdapter* adapter) {
+    relay.base = adapter;
+    relay.adapter.send_data = adapter->send_data;
+    relay.adapter.receive_data = Relay_ReceiveData;
+    relay.adapter.free_data = adapter->free_data;
+    relay.viewer_count = 0;
+    return &relay.adapter;
+}
+
+bool Relay_PushInputs(int frame, const u16* inputs) {
+    // Viewers replay the log from the start of the session, so it can't start late or have gaps
+    if (frame != relay.log.count) {
+        SDL_Log("[relay] expected frame %d, got %d", relay.log.count, frame);
+        return false;
+    }
+
+    log_push(&relay.log, inputs);
+    return true;
+}
+
+static void send_inputs(RelayViewer* v, int first, int count) {
+    u8 packet[RELAY_PACKET_MAX];
+    u8* p = write_header(packet, PACKET_INPUTS);
+
+    write_u32(p, first);
+    write_u16(p + 4, count);
+    p += 6;
+
+    for (int i = 0; i < count; i++) {
+        write_u16(p, relay.log.inputs[first + i][0]);
+        write_u16(p + 2, relay.log.inputs[first + i][1]);
+        p += 4;
+    }
+
+    GekkoNetAddress address = { .data = v->address.data, .size = v->address.size };
+    relay.base->send_data(&address, (const char*)packet, p - packet);
+}
+
+void Relay_Update() {
+    const Uint64 now = SDL_GetTicks();
+
+    for (int i = 0; i < relay.viewer_count; i++) {
+        RelayViewer* v = &relay.viewers[i];
+
+        if (now - v->heard_ms > RELAY_TIMEOUT_MS) {
+            SDL_Log("[relay] viewer %.*s timed out", (int)v->address.size, v->address.data);
+            relay.viewers[i] = relay.viewers[relay.viewer_count - 1];
+            relay.viewer_count -= 1;
+            i -= 1;
+            continue;
+        }
+
+        // Packets may have been lost, start over from what the viewer has confirmed
+        if ((v->sent < v->acked) || (now - v->acked_ms > RELAY_RESEND_MS)) {
+            v->sent = v->acked;
+            v->acked_ms = now;
+        }
+
+        for (int j = 0; (j < RELAY_PACKETS_PER_UPDATE) && (v->sent < relay.log.count); j++) {
+            const int count = SDL_min(relay.log.count - v->sent, RELAY_FRAMES_PER_PACKET);
+            send_inputs(v, v->sent, count);
+            v->sent += count;
+        }
+    }
+}
+
+void Relay_End() {
+    log_free(&relay.log);
+    SDL_free(relay.passed);
+    SDL_zero(relay);
+}
+
+// Viewer
+
+static void handle_inputs(const GekkoNetResult* result) {
+    const u8* p = (const u8*)result->data + RELAY_HEADER_SIZE;
+
+    if (result->data_len < RELAY_HEADER_SIZE + 6) {
+        return;
+    }
+
+    const int first = read_u32(p);
+    const int count = read_u16(p + 4);
+    p += 6;
+
+    if (result->data_len < RELAY_HEADER_SIZE + 6 + count * 4) {
+        return;
+    }
+
+    // Only keep frames that directly follow the ones we have, the relay resends the rest
+    if (first > viewer.log.count) {
+        return;
+    }
+
+    for (int i = viewer.log.count - first; i < count; i++) {
+        const u16 inputs[2] = { read_u16(p + i * 4), read_u16(p + i * 4 + 2) };
+        log_push(&viewer.log, inputs);
+    }
+}
+
+void RelayViewer_Begin(const char* relay_address, unsigned short port) {
+    viewer.adapter = gekko_default_adapter(port);
+    viewer.relay.size = SDL_strlcpy(viewer.relay.data, relay_address, sizeof(viewer.relay.data));
+    viewer.taken = 0;
+}
+
+void RelayViewer_Update() {
+    int count = 0;
+    GekkoNetResult** results = viewer.adapter->receive_data(&count);
+
+    for (int i = 0; i < count; i++) {
+        GekkoNetResult* result = results[i];
+
+        if (is_relay_packet(result) && (((const u8*)result->data)[sizeof(relay_tag)] == PACKET_INPUTS)) {
+            handle_inputs(result);
+        }
+
+        free_result(viewer.adapter, result);
+    }
+
+    // Hellos double as acknowledgements and keep the relay from timing us out
+    u8 packet[RELAY_HEADER_SIZE + 4];
+    write_u32(write_header(packet, PACKET_HELLO), viewer.log.count);
+
+    GekkoNetAddress address = { .data = viewer.relay.data, .size = viewer.relay.size };
+    viewer.adapter->send_data(&address, (const char*)packet, sizeof(packet));
+}
+
+int RelayViewer_FramesAvailable() {
+    return viewer.log.count - viewer.taken;
+}
+
+bool RelayViewer_TakeInputs(int* frame, u16* inputs) {
+    if (viewer.taken == viewer.log.count) {
+        return false;
+    }
+
+    *frame = viewer.taken;
+    inputs[0] = viewer.log.inputs[viewer.taken][0];
+    inputs[1] = viewer.log.inputs[viewer.taken][1];
+    viewer.taken += 1;
+    return true;
+}
+
+void RelayViewer_End() {
+    if (viewer.adapter != NULL) {
+        gekko_default_adapter_destroy();
+    }
+
+    log_free(&viewer.log);
+    SDL_zero(viewer);
+}
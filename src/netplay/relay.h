@@ -0,0 +1,51 @@
+#ifndef NETPLAY_RELAY_H
+#define NETPLAY_RELAY_H
+
+#include "types.h"
+
+#include <stdbool.h>
+
+#define Game GekkoGame // workaround: upstream GekkoSessionType::Game collides with void Game()
+#include "gekkonet.h"
+#undef Game
+
+/// Port that relay viewers listen on.
+#define RELAY_VIEWER_PORT 50003
+
+// Relay: a spectator that passes the confirmed inputs it receives on to viewers,
+// so that every additional viewer loads the spectator's uplink instead of the players'.
+// The relay keeps every input from the first frame of the session on. Viewers that join late
+// get the whole log and fast-forward through it, which rebuilds the state and the asset loads
+// that the state depends on. A snapshot couldn't do the latter, so none is sent.
+
+/// Start relaying on the socket of the spectator session.
+/// @return Adapter to hand to GekkoNet. It filters relay packets out of the
+/// incoming data.
+GekkoNetAdapter* Relay_Begin(GekkoNetAdapter* adapter);
+
+/// Add the confirmed inputs of `frame` to the log. Frames have to be added in order from `0`.
+/// @return `false` if `frame` doesn't follow the log, e.g. because the spectator joined late.
+bool Relay_PushInputs(int frame, const u16* inputs);
+
+/// Send new inputs to viewers and forget viewers that went quiet.
+void Relay_Update();
+void Relay_End();
+
+/// Start watching the relay at `relay_address` ("ip:port") from the default
+/// GekkoNet socket on `port`.
+void RelayViewer_Begin(const char* relay_address, unsigned short port);
+
+/// Receive inputs and acknowledge them to the relay.
+void RelayViewer_Update();
+
+/// @return Number of received frames that haven't been taken yet.
+int RelayViewer_FramesAvailable();
+
+/// Take the inputs of the next frame, starting from frame `0`.
+/// @return `false` if they haven't been received yet.
+bool RelayViewer_TakeInputs(int* frame, u16* inputs);
+
+/// Stop watching and close the socket. Does nothing if watching never started.
+void RelayViewer_End();
+
+#endif
@@ -0,0 +1,253 @@
+#include "netplay/telemetry.h"
+
+#define TELEMETRY_INTERVAL_FRAMES 60
+
+// Histogram bins are exact below 32 and have 32 bins per power of two above,
+// which keeps percentiles within about 3% while covering the whole u32 range
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BINS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BINS (HISTOGRAM_SUB_BINS * (32 - HISTOGRAM_SUB_BITS + 1))
+
+typedef struct Histogram {
+    u32 counts[HISTOGRAM_BINS];
+    u64 total;
+    u64 sum;
+    u32 max;
+} Histogram;
+
+typedef struct TelemetryWindow {
+    int frames;
+    int rollbacks;
+    int resimulated_frames;
+    Histogram rollback_depth;           // In frames
+    Histogram timers[TELEMETRY_TIMER_COUNT]; // In microseconds
+    float frames_behind_min;
+    float frames_behind_max;
+    double frames_behind_sum;
+} TelemetryWindow;
+
+typedef struct Telemetry {
+    TelemetryWindow second;
+    TelemetryWindow session;
+    Uint64 begin_ns;
+    Uint64 last_frame_ns;
+    SDL_IOStream* csv;
+    char overlay[160];
+    bool has_overlay;
+} Telemetry;
+
+static Telemetry telemetry;
+
+static int histogram_bin(u32 value) {
+    if (value < HISTOGRAM_SUB_BINS) {
+        return value;
+    }
+
+    const int msb = SDL_MostSignificantBitIndex32(value);
+    const int octave = msb - HISTOGRAM_SUB_BITS + 1;
+    const int sub = (value >> (msb - HISTOGRAM_SUB_BITS)) - HISTOGRAM_SUB_BINS;
+    return octave * HISTOGRAM_SUB_BINS + sub;
+}
+
+/// @return Smallest value that falls into `bin`.
+static u32 bin_value(int bin) {
+    if (bin < HISTOGRAM_SUB_BINS) {
+        return bin;
+    }
+
+    const int octave = bin / HISTOGRAM_SUB_BINS;
+    const int sub = bin % HISTOGRAM_SUB_BINS;
+    return (u32)(HISTOGRAM_SUB_BINS + sub) << (octave - 1);
+}
+
+static void histogram_add(Histogram* h, u32 value) {
+    h->counts[histogram_bin(value)] += 1;
+    h->total += 1;
+    h->sum += value;
+    h->max = SDL_max(h->max, value);
+}
+
+static u32 histogram_percentile(const Histogram* h, double percentile) {
+    const u64 target = SDL_ceil(h->total * percentile / 100);
+    u64 seen = 0;
+
+    if (h->total == 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        seen += h->counts[i];
+
+        if (seen >= target) {
+            return SDL_min(bin_value(i), h->max);
+        }
+    }
+
+    return h->max;
+}
+
+static double histogram_average(const Histogram* h) {
+    return (h->total > 0) ? (double)h->sum / h->total : 0;
+}
+
+static void reset_window(TelemetryWindow* w) {
+    SDL_zerop(w);
+    w->frames_behind_min = SDL_MAX_SINT32;
+    w->frames_behind_max = SDL_MIN_SINT32;
+}
+
+void Telemetry_Begin(const char* csv_path) {
+    Telemetry_End();
+    reset_window(&telemetry.second);
+    reset_window(&telemetry.session);
+    telemetry.begin_ns = SDL_GetTicksNS();
+
+    if (csv_path == NULL) {
+        return;
+    }
+
+    telemetry.csv = SDL_IOFromFile(csv_path, "w");
+
+    if (telemetry.csv == NULL) {
+        SDL_Log("Failed to open %s for telemetry: %s", csv_path, SDL_GetError());
+        return;
+    }
+
+    SDL_IOprintf(telemetry.csv,
+                 "time_s,frames,rollbacks,rollback_depth_avg,rollback_depth_max,resimulated_frames,"
+                 "save_avg_us,save_p99_us,load_avg_us,load_p99_us,advance_avg_us,advance_p99_us,"
+                 "advance_rendered_avg_us,advance_rendered_p99_us,frame_p50_us,frame_p99_us,frame_max_us,"
+                 "frames_behind_min,frames_behind_avg,frames_behind_max\n");
+}
+
+void Telemetry_NoteTime(TelemetryTimer timer, Uint64 ns) {
+    const u32 us = SDL_min(ns / 1000, SDL_MAX_UINT32);
+    histogram_add(&telemetry.second.timers[timer], us);
+    histogram_add(&telemetry.session.timers[timer], us);
+}
+
+void Telemetry_NoteRollback(int depth) {
+    telemetry.second.rollbacks += 1;
+    telemetry.session.rollbacks += 1;
+    histogram_add(&telemetry.second.rollback_depth, depth);
+    histogram_add(&telemetry.session.rollback_depth, depth);
+}
+
+void Telemetry_NoteResimulatedFrame() {
+    telemetry.second.resimulated_frames += 1;
+    telemetry.session.resimulated_frames += 1;
+}
+
+static void note_frame(TelemetryWindow* w, float frames_behind) {
+    w->frames += 1;
+    w->frames_behind_min = SDL_min(w->frames_behind_min, frames_behind);
+    w->frames_behind_max = SDL_max(w->frames_behind_max, frames_behind);
+    w->frames_behind_sum += frames_behind;
+}
+
+static void update_overlay(const TelemetryWindow* w) {
+    const Histogram* timers = w->timers;
+
+    SDL_snprintf(telemetry.overlay,
+                 sizeof(telemetry.overlay),
+                 "RB %d d%.1f/%u RS %d | S %.2f L %.2f A %.2f/%.2f ms | behind %.1f..%.1f",
+                 w->rollbacks,
+                 histogram_average(&w->rollback_depth),
+                 w->rollback_depth.max,
+                 w->resimulated_frames,
+                 histogram_average(&timers[TELEMETRY_SAVE]) / 1000,
+                 histogram_average(&timers[TELEMETRY_LOAD]) / 1000,
+                 histogram_average(&timers[TELEMETRY_ADVANCE]) / 1000,
+                 histogram_average(&timers[TELEMETRY_ADVANCE_RENDERED]) / 1000,
+                 w->frames_behind_min,
+                 w->frames_behind_max);
+
+    telemetry.has_overlay = true;
+}
+
+static void write_csv_row(const TelemetryWindow* w) {
+    const Histogram* timers = w->timers;
+
+    SDL_IOprintf(telemetry.csv,
+                 "%.3f,%d,%d,%.2f,%u,%d,%.1f,%u,%.1f,%u,%.1f,%u,%.1f,%u,%u,%u,%u,%.2f,%.2f,%.2f\n",
+                 (SDL_GetTicksNS() - telemetry.begin_ns) / 1e9,
+                 w->frames,
+                 w->rollbacks,
+                 histogram_average(&w->rollback_depth),
+                 w->rollback_depth.max,
+                 w->resimulated_frames,
+                 histogram_average(&timers[TELEMETRY_SAVE]),
+                 histogram_percentile(&timers[TELEMETRY_SAVE], 99),
+                 histogram_average(&timers[TELEMETRY_LOAD]),
+                 histogram_percentile(&timers[TELEMETRY_LOAD], 99),
+                 histogram_average(&timers[TELEMETRY_ADVANCE]),
+                 histogram_percentile(&timers[TELEMETRY_ADVANCE], 99),
+                 histogram_average(&timers[TELEMETRY_ADVANCE_RENDERED]),
+                 histogram_percentile(&timers[TELEMETRY_ADVANCE_RENDERED], 99),
+                 histogram_percentile(&timers[TELEMETRY_FRAME], 50),
+                 histogram_percentile(&timers[TELEMETRY_FRAME], 99),
+                 timers[TELEMETRY_FRAME].max,
+                 w->frames_behind_min,
+                 w->frames_behind_sum / w->frames,
+                 w->frames_behind_max);
+}
+
+void Telemetry_EndFrame(float frames_behind) {
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (telemetry.last_frame_ns != 0) {
+        Telemetry_NoteTime(TELEMETRY_FRAME, now - telemetry.last_frame_ns);
+    }
+
+    telemetry.last_frame_ns = now;
+    note_frame(&telemetry.second, frames_behind);
+    note_frame(&telemetry.session, frames_behind);
+
+    if (telemetry.second.frames < TELEMETRY_INTERVAL_FRAMES) {
+        return;
+    }
+
+    update_overlay(&telemetry.second);
+
+    if (telemetry.csv != NULL) {
+        write_csv_row(&telemetry.second);
+    }
+
+    reset_window(&telemetry.second);
+}
+
+void Telemetry_LogSummary() {
+    const TelemetryWindow* w = &telemetry.session;
+    const Histogram* frame = &w->timers[TELEMETRY_FRAME];
+    const double seconds = (SDL_GetTicksNS() - telemetry.begin_ns) / 1e9;
+
+    if (w->frames == 0) {
+        return;
+    }
+
+    SDL_Log("[telemetry] %d frames in %.1f s | %.2f rollbacks/s (depth avg %.2f, p99 %u, max %u), "
+            "%.2f resimulated frames/s | frame time p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms",
+            w->frames,
+            seconds,
+            w->rollbacks / seconds,
+            histogram_average(&w->rollback_depth),
+            histogram_percentile(&w->rollback_depth, 99),
+            w->rollback_depth.max,
+            w->resimulated_frames / seconds,
+            histogram_percentile(frame, 50) / 1000.0,
+            histogram_percentile(frame, 95) / 1000.0,
+            histogram_percentile(frame, 99) / 1000.0,
+            frame->max / 1000.0);
+}
+
+const char* Telemetry_GetOverlayText() {
+    return telemetry.has_overlay ? telemetry.overlay : NULL;
+}
+
+void Telemetry_End() {
+    if (telemetry.csv != NULL) {
+        SDL_CloseIO(telemetry.csv);
+    }
+
+    SDL_zero(telemetry);
+}
@@ -0,0 +1,38 @@
+#ifndef NETPLAY_TELEMETRY_H
+#define NETPLAY_TELEMETRY_H
+
+#include "types.h"
+
+#include <SDL3/SDL.h>
+
+typedef enum TelemetryTimer {
+    TELEMETRY_SAVE,
+    TELEMETRY_LOAD,
+    TELEMETRY_ADVANCE,          // Resimulated or skipped frames, nothing is drawn
+    TELEMETRY_ADVANCE_RENDERED, // Frames that are drawn
+    TELEMETRY_FRAME,            // Time between two netplay updates
+    TELEMETRY_TIMER_COUNT,
+} TelemetryTimer;
+
+/// Start collecting telemetry for a session.
+/// @param csv_path File that gets a row of aggregates every second, `NULL` to not export.
+void Telemetry_Begin(const char* csv_path);
+
+void Telemetry_NoteTime(TelemetryTimer timer, Uint64 ns);
+
+/// Note a rollback of `depth` frames.
+void Telemetry_NoteRollback(int depth);
+void Telemetry_NoteResimulatedFrame();
+
+/// Close the current netplay update. Every second this updates the overlay text and writes a CSV row.
+void Telemetry_EndFrame(float frames_behind);
+
+/// Log rollback rate and frame time percentiles of the whole session.
+void Telemetry_LogSummary();
+
+/// @return One line describing the last second, `NULL` if there's no data yet.
+const char* Telemetry_GetOverlayText();
+
+void Telemetry_End();
+
+#endif
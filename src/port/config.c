@@ -31,6 +31,16 @@ static const ConfigEntry default_entries[] = {
     { .key = CFG_KEY_WINDOW_WIDTH, .type = CFG_INT, .value.i = 640 },
     { .key = CFG_KEY_WINDOW_HEIGHT, .type = CFG_INT, .value.i = 480 },
     { .key = CFG_KEY_SCALEMODE, .type = CFG_STRING, .value.s = "soft-linear" },
+    { .key = CFG_KEY_TEXTURE_CACHE_MB, .type = CFG_INT, .value.i = 128 },
+    { .key = CFG_KEY_PIPELINED_RENDERING, .type = CFG_BOOL, .value.b = false },
+    { .key = CFG_KEY_FRAME_PACING, .type = CFG_STRING, .value.s = "sleep" },
+    { .key = CFG_KEY_FRAME_DELAY, .type = CFG_INT, .value.i = 0 },
+    { .key = CFG_KEY_RUN_AHEAD, .type = CFG_INT, .value.i = 0 },
+    { .key = CFG_KEY_DESYNC_DETECTION, .type = CFG_BOOL, .value.b = true },
+    { .key = CFG_KEY_RENDER_BACKEND, .type = CFG_STRING, .value.s = "gpu" },
+    { .key = CFG_KEY_MAP_AFS, .type = CFG_BOOL, .value.b = false },
+    { .key = CFG_KEY_AFS_PREFETCH_MB, .type = CFG_INT, .value.i = 32 },
+    { .key = CFG_KEY_DECODE_CACHE_MB, .type = CFG_INT, .value.i = 0 },
 };
 
 static ConfigEntry entries[CONFIG_ENTRIES_MAX] = { 0 };
@@ -7,6 +7,16 @@
 #define CFG_KEY_WINDOW_WIDTH "window-width"
 #define CFG_KEY_WINDOW_HEIGHT "window-height"
 #define CFG_KEY_SCALEMODE "scale-mode"
+#define CFG_KEY_TEXTURE_CACHE_MB "texture-cache-mb"
+#define CFG_KEY_PIPELINED_RENDERING "pipelined-rendering"
+#define CFG_KEY_FRAME_PACING "frame-pacing"
+#define CFG_KEY_FRAME_DELAY "frame-delay"
+#define CFG_KEY_RUN_AHEAD "run-ahead"
+#define CFG_KEY_DESYNC_DETECTION "desync-detection"
+#define CFG_KEY_RENDER_BACKEND "render-backend"
+#define CFG_KEY_MAP_AFS "map-afs"
+#define CFG_KEY_AFS_PREFETCH_MB "afs-prefetch-mb"
+#define CFG_KEY_DECODE_CACHE_MB "decode-cache-mb"
 
 /// Initialize config system
 void Config_Init();
@@ -1,5 +1,7 @@
 #include "port/io/afs.h"
 #include "common.h"
+#include "port/io/afs_prefetch.h"
+#include "port/io/mapped_file.h"
 #include <SDL3/SDL.h>
 #include <stdio.h>
 
@@ -23,8 +25,10 @@ typedef struct AFSEntry {
 
 typedef struct AFS {
     char* file_path;
+    Uint64 file_size;
     unsigned int entry_count;
     AFSEntry* entries;
+    MappedFile mapped; // Whole archive, empty when reads go through async IO
 } AFS;
 
 typedef struct ReadRequest {
@@ -92,6 +96,8 @@ static bool init_afs(const char* file_path) {
         return false;
     }
 
+    afs.file_size = SDL_GetIOSize(io);
+
     // Read entries
 
     SDL_ReadU32LE(io, &afs.entry_count);
@@ -158,15 +164,23 @@ static bool init_asyncio(const char* file_path) {
     return asyncio_queue != NULL;
 }
 
-bool AFS_Init(const char* file_path) {
+bool AFS_Init(const char* file_path, bool map_file) {
     if (!init_afs(file_path)) {
         return false;
     }
 
+    if (map_file && !MappedFile_Open(&afs.mapped, file_path)) {
+        SDL_Log("Couldn't map %s, reading it with async IO instead", file_path);
+    }
+
     return init_asyncio(file_path);
 }
 
 void AFS_Finish() {
+    AFSPrefetch_Finish();
+
+    MappedFile_Close(&afs.mapped);
+
     SDL_free(afs.file_path);
     SDL_free(afs.entries);
     SDL_zero(afs);
@@ -186,6 +200,52 @@ unsigned int AFS_GetSize(int file_num) {
     return afs.entries[file_num].size;
 }
 
+void AFS_SetPrefetchBudget(size_t budget) {
+    AFSPrefetch_Finish();
+
+    // Reads from a mapped archive are already served from memory
+    if ((budget > 0) && (afs.file_path != NULL) && (afs.mapped.data == NULL)) {
+        AFSPrefetch_Init(afs.file_path, budget);
+    }
+}
+
+void AFS_Prefetch(int file_num) {
+    if ((file_num < 0) || (file_num >= afs.entry_count)) {
+        return;
+    }
+
+    const AFSEntry* entry = &afs.entries[file_num];
+
+    if (entry->offset >= afs.file_size) {
+        return;
+    }
+
+    // Reads are whole sectors and run into the next file, so the prefetched copy does too.
+    // Only the last file of the archive reads short.
+    const Uint64 sectors_size = ((Uint64)entry->size + 2048 - 1) / 2048 * 2048;
+    const Uint64 size = SDL_min(sectors_size, afs.file_size - entry->offset);
+
+    AFSPrefetch_Request(file_num, entry->offset, (unsigned int)size);
+}
+
+bool AFS_IsPrefetching(int file_num) {
+    return AFSPrefetch_IsLoading(file_num);
+}
+
+const void* AFS_GetFileData(int file_num) {
+    if ((afs.mapped.data == NULL) || (file_num < 0) || (file_num >= afs.entry_count)) {
+        return NULL;
+    }
+
+    const AFSEntry* entry = &afs.entries[file_num];
+
+    if (((Uint64)entry->offset + entry->size) > afs.mapped.size) {
+        return NULL;
+    }
+
+    return afs.mapped.data + entry->offset;
+}
+
 // AFS reading
 
 static void process_asyncio_outcome(const SDL_AsyncIOOutcome* outcome) {
@@ -270,6 +330,21 @@ AFSHandle AFS_Open(int file_num) {
     return retval;
 }
 
+/// Serve a read from the mapped archive. It finishes right away, like an async read that completed instantly.
+static void read_mapped(ReadRequest* request, Uint64 offset, int sectors, void* buf) {
+    if (offset > afs.mapped.size) {
+        request->state = AFS_READ_STATE_ERROR;
+        return;
+    }
+
+    // The last file can end before its last sector does. Async IO reads short in that case too.
+    const size_t size = SDL_min((Uint64)sectors * 2048, afs.mapped.size - offset);
+
+    SDL_memcpy(buf, afs.mapped.data + offset, size);
+    request->state = AFS_READ_STATE_FINISHED;
+    request->sector += sectors;
+}
+
 void AFS_Read(AFSHandle handle, int sectors, void* buf) {
 #if defined(AFS_DEBUG)
     printf("📂 %d: read (sectors = %d, bytes = 0x%X)\n", handle, sectors, sectors * 2048);
@@ -278,6 +353,17 @@ void AFS_Read(AFSHandle handle, int sectors, void* buf) {
     ReadRequest* request = &requests[handle];
     const Uint64 offset = afs.entries[request->file_num].offset + request->sector * 2048;
 
+    if (afs.mapped.data != NULL) {
+        read_mapped(request, offset, sectors, buf);
+        return;
+    }
+
+    if (AFSPrefetch_Read(request->file_num, request->sector * 2048, sectors * 2048, buf)) {
+        request->state = AFS_READ_STATE_FINISHED;
+        request->sector += sectors;
+        return;
+    }
+
     request->state = AFS_READ_STATE_READING;
     request->asyncio = SDL_AsyncIOFromFile(afs.file_path, "r");
 
@@ -305,6 +391,11 @@ void AFS_ReadSync(AFSHandle handle, int sectors, void* buf) {
 
     AFS_Read(handle, sectors, buf);
 
+    // Reads from memory finish right away, and failed ones never do
+    if (requests[handle].state != AFS_READ_STATE_READING) {
+        return;
+    }
+
     SDL_AsyncIOOutcome outcome;
 
     while (SDL_WaitAsyncIOResult(asyncio_queue, &outcome, -1)) {
@@ -2,6 +2,7 @@
 #define PORT_IO_AFS_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef enum AFSReadState {
     AFS_READ_STATE_IDLE,
@@ -14,11 +15,27 @@ typedef int AFSHandle;
 
 #define AFS_NONE -1
 
-bool AFS_Init(const char* file_path);
+/// @param map_file Map the whole archive into memory and serve reads from it instead of async IO.
+/// Falls back to async IO if the archive can't be mapped.
+bool AFS_Init(const char* file_path, bool map_file);
 void AFS_Finish();
 unsigned int AFS_GetFileCount();
 unsigned int AFS_GetSize(int file_num);
 
+/// Keep up to `budget` bytes of files requested with `AFS_Prefetch` in memory. `0` turns prefetching off.
+/// Has no effect when the archive is mapped.
+void AFS_SetPrefetchBudget(size_t budget);
+
+/// Start reading a file in the background, so that a later `AFS_Read` of it is served from memory.
+void AFS_Prefetch(int file_num);
+
+/// @return `true` while a prefetched file is being read.
+bool AFS_IsPrefetching(int file_num);
+
+/// @return Read-only pointer to the contents of a file, valid until `AFS_Finish`.
+/// `NULL` if the archive isn't mapped.
+const void* AFS_GetFileData(int file_num);
+
 void AFS_RunServer();
 AFSHandle AFS_Open(int file_num);
 void AFS_Read(AFSHandle handle, int sectors, void* buf);
@@ -0,0 +1,332 @@
+#include "port/io/afs_prefetch.h"
+
+#define PREFETCH_SLOTS_MAX 64
+#define PREFETCH_WORKERS 2 // Each reads a different file, so that several reads are in flight
+
+typedef enum PrefetchSlotState {
+    PREFETCH_SLOT_EMPTY,
+    PREFETCH_SLOT_QUEUED,
+    PREFETCH_SLOT_LOADING, // Owned by the worker until it's ready
+    PREFETCH_SLOT_READY,
+} PrefetchSlotState;
+
+typedef struct PrefetchSlot {
+    PrefetchSlotState state;
+    int file_num;
+    Uint64 offset;
+    unsigned int size;
+    Uint8* data;
+    Uint64 last_touched; // When the file was last requested or read, for priority and LRU eviction
+} PrefetchSlot;
+
+typedef struct Prefetcher {
+    SDL_Thread* workers[PREFETCH_WORKERS];
+    SDL_Mutex* mutex;
+    SDL_Condition* request_added;
+    bool quit;
+    char* file_path;
+    size_t budget;
+    size_t bytes; // Ready and loading files
+    Uint64 clock;
+    PrefetchSlot slots[PREFETCH_SLOTS_MAX];
+    AFSPrefetchStats stats;
+} Prefetcher;
+
+static Prefetcher prefetcher = { 0 };
+
+static bool is_running() {
+    return prefetcher.workers[PREFETCH_WORKERS - 1] != NULL;
+}
+
+static PrefetchSlot* find_slot(int file_num) {
+    for (int i = 0; i < PREFETCH_SLOTS_MAX; i++) {
+        PrefetchSlot* slot = &prefetcher.slots[i];
+
+        if ((slot->state != PREFETCH_SLOT_EMPTY) && (slot->file_num == file_num)) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+/// @return The least recently touched slot in `state`, `NULL` if there's none.
+static PrefetchSlot* oldest_slot(PrefetchSlotState state) {
+    PrefetchSlot* oldest = NULL;
+
+    for (int i = 0; i < PREFETCH_SLOTS_MAX; i++) {
+        PrefetchSlot* slot = &prefetcher.slots[i];
+
+        if ((slot->state == state) && ((oldest == NULL) || (slot->last_touched < oldest->last_touched))) {
+            oldest = slot;
+        }
+    }
+
+    return oldest;
+}
+
+static void empty_slot(PrefetchSlot* slot) {
+    if (slot->state == PREFETCH_SLOT_READY) {
+        prefetcher.bytes -= slot->size;
+        prefetcher.stats.evictions += 1;
+    }
+
+    SDL_free(slot->data);
+    SDL_zerop(slot);
+}
+
+/// @return An empty slot, made by dropping the least recently touched file or request if needed.
+/// `NULL` if every slot is being loaded.
+static PrefetchSlot* find_free_slot() {
+    PrefetchSlot* slot = oldest_slot(PREFETCH_SLOT_EMPTY);
+
+    if (slot == NULL) {
+        slot = oldest_slot(PREFETCH_SLOT_READY);
+    }
+
+    if (slot == NULL) {
+        slot = oldest_slot(PREFETCH_SLOT_QUEUED);
+    }
+
+    if (slot != NULL) {
+        empty_slot(slot);
+    }
+
+    return slot;
+}
+
+/// @return The next file to read, `NULL` when quitting. Must be called with the mutex held.
+static PrefetchSlot* wait_for_request() {
+    while (!prefetcher.quit) {
+        PrefetchSlot* newest = NULL;
+
+        for (int i = 0; i < PREFETCH_SLOTS_MAX; i++) {
+            PrefetchSlot* slot = &prefetcher.slots[i];
+
+            if ((slot->state == PREFETCH_SLOT_QUEUED) &&
+                ((newest == NULL) || (slot->last_touched > newest->last_touched))) {
+                newest = slot;
+            }
+        }
+
+        if (newest != NULL) {
+            return newest;
+        }
+
+        SDL_WaitCondition(prefetcher.request_added, prefetcher.mutex);
+    }
+
+    return NULL;
+}
+
+/// Evict files until `size` more bytes fit in the budget.
+/// @return `false` if they can't fit.
+static bool make_room(unsigned int size) {
+    while ((prefetcher.bytes + size) > prefetcher.budget) {
+        PrefetchSlot* victim = oldest_slot(PREFETCH_SLOT_READY);
+
+        if (victim == NULL) {
+            return false;
+        }
+
+        empty_slot(victim);
+    }
+
+    return true;
+}
+
+static int SDLCALL prefetch_worker(void* data) {
+    SDL_IOStream* io = SDL_IOFromFile(prefetcher.file_path, "rb");
+
+    SDL_LockMutex(prefetcher.mutex);
+
+    while (true) {
+        PrefetchSlot* slot = wait_for_request();
+
+        if (slot == NULL) {
+            break;
+        }
+
+        if ((io == NULL) || !make_room(slot->size)) {
+            empty_slot(slot);
+            continue;
+        }
+
+        const int file_num = slot->file_num;
+        const Uint64 offset = slot->offset;
+        const unsigned int size = slot->size;
+
+        slot->state = PREFETCH_SLOT_LOADING;
+        prefetcher.bytes += size;
+        SDL_UnlockMutex(prefetcher.mutex);
+
+        Uint8* buf = SDL_malloc(size);
+        const bool success = (buf != NULL) && (SDL_SeekIO(io, offset, SDL_IO_SEEK_SET) >= 0) &&
+                             (SDL_ReadIO(io, buf, size) == size);
+
+        SDL_LockMutex(prefetcher.mutex);
+
+        // Loading slots aren't evicted or reused, so `slot` still holds `file_num`
+        SDL_assert(slot->file_num == file_num);
+
+        if (!success) {
+            SDL_free(buf);
+            prefetcher.bytes -= size;
+            SDL_zerop(slot);
+            continue;
+        }
+
+        slot->data = buf;
+        slot->state = PREFETCH_SLOT_READY;
+        prefetcher.stats.bytes_read += size;
+    }
+
+    SDL_UnlockMutex(prefetcher.mutex);
+
+    if (io != NULL) {
+        SDL_CloseIO(io);
+    }
+
+    return 0;
+}
+
+bool AFSPrefetch_Init(const char* file_path, size_t budget) {
+    AFSPrefetch_Finish();
+
+    prefetcher.file_path = SDL_strdup(file_path);
+    prefetcher.budget = budget;
+    prefetcher.mutex = SDL_CreateMutex();
+    prefetcher.request_added = SDL_CreateCondition();
+    for (int i = 0; i < PREFETCH_WORKERS; i++) {
+        prefetcher.workers[i] = SDL_CreateThread(prefetch_worker, "afs prefetch", NULL);
+
+        if (prefetcher.workers[i] == NULL) {
+            SDL_Log("Failed to start AFS prefetch worker: %s", SDL_GetError());
+            AFSPrefetch_Finish();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AFSPrefetch_Finish() {
+    const AFSPrefetchStats* stats = &prefetcher.stats;
+
+    if ((stats->hits + stats->late + stats->misses) > 0) {
+        SDL_Log("[afs prefetch] %d hits, %d late, %d misses | %.1f MB read, %d evictions",
+                stats->hits,
+                stats->late,
+                stats->misses,
+                stats->bytes_read / (1024.0 * 1024.0),
+                stats->evictions);
+    }
+
+    if (prefetcher.mutex != NULL) {
+        SDL_LockMutex(prefetcher.mutex);
+        prefetcher.quit = true;
+        SDL_BroadcastCondition(prefetcher.request_added);
+        SDL_UnlockMutex(prefetcher.mutex);
+    }
+
+    for (int i = 0; i < PREFETCH_WORKERS; i++) {
+        SDL_WaitThread(prefetcher.workers[i], NULL);
+    }
+
+    for (int i = 0; i < PREFETCH_SLOTS_MAX; i++) {
+        SDL_free(prefetcher.slots[i].data);
+    }
+
+    SDL_DestroyCondition(prefetcher.request_added);
+    SDL_DestroyMutex(prefetcher.mutex);
+    SDL_free(prefetcher.file_path);
+    SDL_zero(prefetcher);
+}
+
+void AFSPrefetch_Request(int file_num, Uint64 offset, unsigned int size) {
+    if ((!is_running()) || (size == 0) || (size > prefetcher.budget)) {
+        return;
+    }
+
+    SDL_LockMutex(prefetcher.mutex);
+    prefetcher.clock += 1;
+
+    PrefetchSlot* slot = find_slot(file_num);
+
+    if (slot != NULL) {
+        slot->last_touched = prefetcher.clock;
+        SDL_UnlockMutex(prefetcher.mutex);
+        return;
+    }
+
+    slot = find_free_slot();
+
+    if (slot != NULL) {
+        slot->state = PREFETCH_SLOT_QUEUED;
+        slot->file_num = file_num;
+        slot->offset = offset;
+        slot->size = size;
+        slot->last_touched = prefetcher.clock;
+        SDL_SignalCondition(prefetcher.request_added);
+    }
+
+    SDL_UnlockMutex(prefetcher.mutex);
+}
+
+bool AFSPrefetch_IsLoading(int file_num) {
+    if (!is_running()) {
+        return false;
+    }
+
+    SDL_LockMutex(prefetcher.mutex);
+    const PrefetchSlot* slot = find_slot(file_num);
+    const bool loading = (slot != NULL) && (slot->state == PREFETCH_SLOT_LOADING);
+    SDL_UnlockMutex(prefetcher.mutex);
+    return loading;
+}
+
+bool AFSPrefetch_Read(int file_num, unsigned int offset, unsigned int size, void* buf) {
+    if (!is_running()) {
+        return false;
+    }
+
+    SDL_LockMutex(prefetcher.mutex);
+
+    PrefetchSlot* slot = find_slot(file_num);
+    bool hit = false;
+
+    if (slot == NULL) {
+        prefetcher.stats.misses += 1;
+    } else if (slot->state == PREFETCH_SLOT_QUEUED) {
+        // The file is about to be read anyway, so the worker doesn't need to
+        prefetcher.stats.misses += 1;
+        SDL_zerop(slot);
+    } else if (slot->state == PREFETCH_SLOT_LOADING) {
+        prefetcher.stats.late += 1;
+    } else if (offset <= slot->size) {
+        // Slots hold whole sectors, so this reads short only where the archive ends, like async IO
+        SDL_memcpy(buf, slot->data + offset, SDL_min(size, slot->size - offset));
+        prefetcher.clock += 1;
+        slot->last_touched = prefetcher.clock;
+        prefetcher.stats.hits += 1;
+        hit = true;
+    } else {
+        prefetcher.stats.misses += 1;
+    }
+
+    SDL_UnlockMutex(prefetcher.mutex);
+    return hit;
+}
+
+AFSPrefetchStats AFSPrefetch_GetStats() {
+    AFSPrefetchStats stats = { 0 };
+
+    if (!is_running()) {
+        return stats;
+    }
+
+    SDL_LockMutex(prefetcher.mutex);
+    stats = prefetcher.stats;
+    SDL_UnlockMutex(prefetcher.mutex);
+    return stats;
+}
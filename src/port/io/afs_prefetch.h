@@ -0,0 +1,36 @@
+#ifndef PORT_IO_AFS_PREFETCH_H
+#define PORT_IO_AFS_PREFETCH_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+typedef struct AFSPrefetchStats {
+    int hits;           // Reads served from memory
+    int misses;         // Reads of files that weren't requested, or whose request hadn't started
+    int late;           // Reads of files that were still being prefetched
+    int evictions;      // Files dropped to stay within the budget
+    Uint64 bytes_read;  // Bytes read by the worker
+} AFSPrefetchStats;
+
+/// Start the worker that reads files of the archive at `file_path` ahead of time.
+/// At most `budget` bytes of prefetched files are kept in memory.
+bool AFSPrefetch_Init(const char* file_path, size_t budget);
+void AFSPrefetch_Finish();
+
+/// Queue a file to be read in the background. The files requested last are read first,
+/// so requesting a file that's already queued moves it to the front.
+/// @param offset Offset of the file in the archive.
+/// @param size Bytes to read, rounded up to whole sectors like the reads that will be served.
+void AFSPrefetch_Request(int file_num, Uint64 offset, unsigned int size);
+
+/// @return `true` while the worker is reading the file.
+bool AFSPrefetch_IsLoading(int file_num);
+
+/// Copy up to `size` bytes, starting `offset` bytes into a prefetched file.
+/// @return `true` if the file was in memory, `false` if it has to be read from the archive.
+bool AFSPrefetch_Read(int file_num, unsigned int offset, unsigned int size, void* buf);
+
+AFSPrefetchStats AFSPrefetch_GetStats();
+
+#endif
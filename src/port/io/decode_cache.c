@@ -0,0 +1,282 @@
+#include "port/io/decode_cache.h"
+#include "port/io/mapped_file.h"
+
+// The cache is one file: a header, then records of a RecordHeader followed by the decoded
+// data, padded so that every record starts 16-byte aligned. Records are only ever appended.
+// The file is written in native byte order, and thrown away when it doesn't match the header.
+
+#define DECODE_CACHE_FILE_NAME "decoded_assets.bin"
+#define DECODE_CACHE_MAGIC 0x33445843 // "CXD3"
+#define DECODE_CACHE_VERSION 1
+#define DECODE_CACHE_BYTE_ORDER 0x01020304
+#define DECODE_CACHE_ALIGNMENT 16
+#define INDEX_CAPACITY_INITIAL 1024
+#define NOT_MAPPED SIZE_MAX // Offset of records written this run
+
+typedef struct FileHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 byte_order;
+    Uint32 reserved;
+} FileHeader;
+
+typedef struct RecordHeader {
+    Uint64 key;
+    Uint32 size;
+    Uint32 reserved;
+} RecordHeader;
+
+typedef struct IndexEntry {
+    Uint64 key;
+    size_t offset; // Of the data in the mapped file
+    Uint32 size;
+    bool used;
+} IndexEntry;
+
+typedef struct DecodeCache {
+    bool enabled;
+    char* path;
+    size_t budget;
+    MappedFile mapped;
+    SDL_IOStream* writer;
+    bool write_failed; // Stored data is still loaded, nothing new is written
+    Uint64 file_size;
+
+    // Open addressing, at most half full
+    IndexEntry* index;
+    size_t index_capacity;
+    size_t index_count;
+
+    int hits;
+    int misses;
+    Uint64 bytes_stored;
+} DecodeCache;
+
+static DecodeCache cache = { 0 };
+
+static Uint64 record_size(Uint32 size) {
+    const Uint64 unpadded = sizeof(RecordHeader) + (Uint64)size;
+    return (unpadded + DECODE_CACHE_ALIGNMENT - 1) & ~(Uint64)(DECODE_CACHE_ALIGNMENT - 1);
+}
+
+static IndexEntry* find_entry(Uint64 key) {
+    if (cache.index == NULL) {
+        return NULL;
+    }
+
+    size_t i = key & (cache.index_capacity - 1);
+
+    while (cache.index[i].used) {
+        if (cache.index[i].key == key) {
+            return &cache.index[i];
+        }
+
+        i = (i + 1) & (cache.index_capacity - 1);
+    }
+
+    return NULL;
+}
+
+static void insert_entry(const IndexEntry* entry) {
+    size_t i = entry->key & (cache.index_capacity - 1);
+
+    while (cache.index[i].used) {
+        i = (i + 1) & (cache.index_capacity - 1);
+    }
+
+    cache.index[i] = *entry;
+    cache.index[i].used = true;
+    cache.index_count += 1;
+}
+
+static void add_entry(Uint64 key, size_t offset, Uint32 size) {
+    if (((cache.index_count + 1) * 2) > cache.index_capacity) {
+        IndexEntry* old_index = cache.index;
+        const size_t old_capacity = cache.index_capacity;
+
+        cache.index_capacity = (old_capacity > 0) ? old_capacity * 2 : INDEX_CAPACITY_INITIAL;
+        cache.index = SDL_calloc(cache.index_capacity, sizeof(IndexEntry));
+        cache.index_count = 0;
+
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_index[i].used) {
+                insert_entry(&old_index[i]);
+            }
+        }
+
+        SDL_free(old_index);
+    }
+
+    const IndexEntry entry = { .key = key, .offset = offset, .size = size };
+    insert_entry(&entry);
+}
+
+/// Index the records of the mapped file.
+/// @return `false` if the file is from another version, or was cut short.
+static bool index_mapped_file() {
+    const FileHeader* header = (const FileHeader*)cache.mapped.data;
+    size_t offset = sizeof(FileHeader);
+
+    if ((cache.mapped.size < sizeof(FileHeader)) || (header->magic != DECODE_CACHE_MAGIC) ||
+        (header->version != DECODE_CACHE_VERSION) || (header->byte_order != DECODE_CACHE_BYTE_ORDER)) {
+        return false;
+    }
+
+    while (offset < cache.mapped.size) {
+        if ((cache.mapped.size - offset) < sizeof(RecordHeader)) {
+            return false;
+        }
+
+        const RecordHeader* record = (const RecordHeader*)(cache.mapped.data + offset);
+        const Uint64 size = record_size(record->size);
+
+        if (size > (cache.mapped.size - offset)) {
+            return false;
+        }
+
+        if (find_entry(record->key) == NULL) {
+            add_entry(record->key, offset + sizeof(RecordHeader), record->size);
+        }
+
+        offset += size;
+    }
+
+    return true;
+}
+
+static void reset_file() {
+    MappedFile_Close(&cache.mapped);
+    SDL_free(cache.index);
+    cache.index = NULL;
+    cache.index_capacity = 0;
+    cache.index_count = 0;
+    SDL_RemovePath(cache.path);
+}
+
+void DecodeCache_Init(const char* dir, size_t budget) {
+    DecodeCache_Finish();
+
+    if (budget == 0) {
+        return;
+    }
+
+    SDL_asprintf(&cache.path, "%s%s", dir, DECODE_CACHE_FILE_NAME);
+    cache.budget = budget;
+    cache.enabled = true;
+
+    if (!MappedFile_Open(&cache.mapped, cache.path)) {
+        // Missing, empty or unreadable. Either way, new records go into a new file.
+        SDL_RemovePath(cache.path);
+    } else if (!index_mapped_file()) {
+        SDL_Log("Decoded asset cache %s is outdated or damaged, starting over", cache.path);
+        reset_file();
+    }
+
+    cache.file_size = cache.mapped.size;
+}
+
+void DecodeCache_Finish() {
+    if (cache.enabled && ((cache.hits + cache.misses) > 0)) {
+        SDL_Log("[decode cache] %d hits, %d misses | %.1f MB stored this run",
+                cache.hits,
+                cache.misses,
+                cache.bytes_stored / (1024.0 * 1024.0));
+    }
+
+    if (cache.writer != NULL) {
+        SDL_CloseIO(cache.writer);
+    }
+
+    MappedFile_Close(&cache.mapped);
+    SDL_free(cache.index);
+    SDL_free(cache.path);
+    SDL_zero(cache);
+}
+
+bool DecodeCache_IsEnabled() {
+    return cache.enabled;
+}
+
+bool DecodeCache_Load(Uint64 key, void* dst, size_t size) {
+    if (!cache.enabled) {
+        return false;
+    }
+
+    const IndexEntry* entry = find_entry(key);
+
+    if ((entry == NULL) || (entry->offset == NOT_MAPPED) || (entry->size != size)) {
+        cache.misses += 1;
+        return false;
+    }
+
+    SDL_memcpy(dst, cache.mapped.data + entry->offset, size);
+    cache.hits += 1;
+    return true;
+}
+
+static bool open_writer() {
+    cache.writer = SDL_IOFromFile(cache.path, "ab");
+
+    if (cache.writer == NULL) {
+        return false;
+    }
+
+    if (cache.file_size == 0) {
+        const FileHeader header = { .magic = DECODE_CACHE_MAGIC,
+                                    .version = DECODE_CACHE_VERSION,
+                                    .byte_order = DECODE_CACHE_BYTE_ORDER };
+
+        if (SDL_WriteIO(cache.writer, &header, sizeof(header)) != sizeof(header)) {
+            return false;
+        }
+
+        cache.file_size = sizeof(header);
+    }
+
+    return true;
+}
+
+static void stop_writing() {
+    SDL_Log("Couldn't write to decoded asset cache %s: %s", cache.path, SDL_GetError());
+
+    if (cache.writer != NULL) {
+        SDL_CloseIO(cache.writer);
+        cache.writer = NULL;
+    }
+
+    cache.write_failed = true;
+}
+
+void DecodeCache_Store(Uint64 key, const void* data, size_t size) {
+    static const Uint8 padding[DECODE_CACHE_ALIGNMENT] = { 0 };
+
+    if (!cache.enabled || (size > SDL_MAX_UINT32) || (find_entry(key) != NULL)) {
+        return;
+    }
+
+    const Uint64 size_in_file = record_size(size);
+    const size_t padding_size = size_in_file - sizeof(RecordHeader) - size;
+
+    if (cache.write_failed || ((SDL_max(cache.file_size, sizeof(FileHeader)) + size_in_file) > cache.budget)) {
+        return;
+    }
+
+    if ((cache.writer == NULL) && !open_writer()) {
+        stop_writing();
+        return;
+    }
+
+    const RecordHeader record = { .key = key, .size = size };
+
+    // A record that's cut short makes the next run start over, so failures need no cleanup here
+    if ((SDL_WriteIO(cache.writer, &record, sizeof(record)) != sizeof(record)) ||
+        (SDL_WriteIO(cache.writer, data, size) != size) ||
+        (SDL_WriteIO(cache.writer, padding, padding_size) != padding_size)) {
+        stop_writing();
+        return;
+    }
+
+    cache.file_size += size_in_file;
+    cache.bytes_stored += size;
+    add_entry(key, NOT_MAPPED, size);
+}
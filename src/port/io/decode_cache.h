@@ -0,0 +1,23 @@
+#ifndef PORT_IO_DECODE_CACHE_H
+#define PORT_IO_DECODE_CACHE_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+/// Open the cache file in `dir` and map what previous runs stored. New data is appended
+/// until the file reaches `budget` bytes, and can be loaded from the next run on.
+/// Must only be used from the main thread.
+void DecodeCache_Init(const char* dir, size_t budget);
+void DecodeCache_Finish();
+
+/// @return `true` if the cache was opened with a budget, so keys are worth computing.
+bool DecodeCache_IsEnabled();
+
+/// @param key Identifies the source data and how it was decoded.
+/// @return `true` if `size` bytes were stored for `key` and copied to `dst`.
+bool DecodeCache_Load(Uint64 key, void* dst, size_t size);
+
+void DecodeCache_Store(Uint64 key, const void* data, size_t size);
+
+#endif
@@ -0,0 +1,95 @@
+#include "port/io/mapped_file.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+bool MappedFile_Open(MappedFile* file, const char* path) {
+    SDL_zerop(file);
+
+    wchar_t* wide_path = (wchar_t*)SDL_iconv_string("UTF-16LE", "UTF-8", path, SDL_strlen(path) + 1);
+
+    if (wide_path == NULL) {
+        return false;
+    }
+
+    HANDLE handle = CreateFileW(wide_path,
+                                GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                NULL,
+                                OPEN_EXISTING,
+                                FILE_FLAG_RANDOM_ACCESS,
+                                NULL);
+    SDL_free(wide_path);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = NULL;
+
+    if (GetFileSizeEx(handle, &file_size) && (file_size.QuadPart > 0) && (file_size.QuadPart <= SIZE_MAX)) {
+        mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+
+    if (mapping != NULL) {
+        file->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        file->size = (file->data != NULL) ? (size_t)file_size.QuadPart : 0;
+
+        // The view keeps the file open
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(handle);
+    return file->data != NULL;
+}
+
+void MappedFile_Close(MappedFile* file) {
+    if (file->data != NULL) {
+        UnmapViewOfFile(file->data);
+    }
+
+    SDL_zerop(file);
+}
+#else
+bool MappedFile_Open(MappedFile* file, const char* path) {
+    SDL_zerop(file);
+
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0) && ((Uint64)st.st_size <= SIZE_MAX)) {
+        void* data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (data != MAP_FAILED) {
+            file->data = data;
+            file->size = st.st_size;
+        }
+    }
+
+    // The mapping keeps the file open
+    close(fd);
+    return file->data != NULL;
+}
+
+void MappedFile_Close(MappedFile* file) {
+    if (file->data != NULL) {
+        munmap((void*)file->data, file->size);
+    }
+
+    SDL_zerop(file);
+}
+#endif
@@ -0,0 +1,20 @@
+#ifndef PORT_IO_MAPPED_FILE_H
+#define PORT_IO_MAPPED_FILE_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+typedef struct MappedFile {
+    const Uint8* data;
+    size_t size;
+} MappedFile;
+
+/// Map a whole file into memory, read-only. The file can still be appended to while it's mapped,
+/// but the mapping keeps the size it had when it was opened.
+/// @return `false` if the file can't be mapped or is empty.
+bool MappedFile_Open(MappedFile* file, const char* path);
+
+void MappedFile_Close(MappedFile* file);
+
+#endif
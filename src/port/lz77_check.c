@@ -0,0 +1,632 @@
+#include "port/lz77_check.h"
+#include "port/io/afs.h"
+#include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
+
+#include <SDL3/SDL.h>
+
+#define CHUNK_HEADER_SIZE 0x10
+#define CHUNK_EXP_SIZE_MAX (64 * 1024 * 1024)
+#define BENCHMARK_PASSES 20
+#define FUZZ_DST_SIZE_MAX 0x20000
+#define FUZZ_GUARD_SIZE 64
+#define FUZZ_GUARD_BYTE 0xA5
+#define FUZZ_UNKNOWN_OPS_MAX 64
+
+// Every operation outputs at least one byte for at most five
+#define FUZZ_SRC_SIZE(dst_size) (5 * (dst_size) + FUZZ_UNKNOWN_OPS_MAX)
+
+typedef struct Chunk {
+    int file_num;
+    unsigned int file_offset;
+    u8* src; // Allocated to exactly `src_size` bytes, so that sanitizers catch overreads
+    s32 src_size;
+    s32 dst_size;
+} Chunk;
+
+typedef struct ChunkList {
+    Chunk* items;
+    int count;
+    int capacity;
+    int skipped;
+    Uint64 dst_bytes;
+} ChunkList;
+
+typedef s32 (*Decoder)(const Chunk* chunk, u8* dst);
+
+/// The decoder as it was before it was rewritten, kept as the reference output. With `checked`
+/// set, it stops instead of reading past `src_end`, before the start of `dst` or past `size` bytes.
+static inline s32 decode_reference_impl(const u8* src, const u8* src_end, u8* dst, s32 size, bool checked) {
+    const u8* const dst_begin = dst;
+    s32 j;
+    s32 loop;
+    const u8* dic;
+    u8 num;
+    u8 step;
+    u16 offset;
+
+#define NEED_SRC(n)                                                                                                    \
+    if (checked && ((src_end - src) < (n))) {                                                                          \
+        return 0;                                                                                                      \
+    }
+
+#define NEED_DST(n)                                                                                                    \
+    if (checked && (size < (n))) {                                                                                     \
+        return 0;                                                                                                      \
+    }
+
+#define NEED_DIC(n)                                                                                                    \
+    if (checked && ((dst - dst_begin) < (n))) {                                                                        \
+        return 0;                                                                                                      \
+    }
+
+    while (size > 0) {
+        NEED_SRC(1);
+        offset = *src++;
+
+        if (offset & 0x80) {
+            if (offset & 0x40) {
+                NEED_SRC(2);
+                offset = ((offset << 8) | *src++) & 0x3FFF;
+
+                if (offset == 0) {
+                    offset = 0x4000;
+                }
+
+                loop = *src++;
+
+                if (loop & 0x80) {
+                    NEED_SRC(1);
+                    step = *src++;
+                } else {
+                    step = 0;
+                }
+
+                loop &= 0x7F;
+
+                if (loop == 0) {
+                    loop = 0x80;
+                }
+
+                NEED_DST(loop);
+                NEED_DIC(offset);
+                dic = dst - offset;
+
+                for (j = 0; j < loop; j++) {
+                    *dst++ = *dic++ + step;
+                }
+
+                size -= loop;
+            } else {
+                switch (offset & 0x3F) {
+                case 1:
+                case 2:
+                    if ((offset & 0x3F) == 1) {
+                        NEED_SRC(1);
+                        loop = *src++;
+                        loop = (loop == 0) ? 0x100 : loop;
+                    } else {
+                        NEED_SRC(2);
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+                        loop = (loop == 0) ? 0x10000 : loop;
+                    }
+
+                    NEED_SRC(loop);
+                    NEED_DST(loop);
+
+                    for (j = 0; j < loop; j++) {
+                        *dst++ = *src++;
+                    }
+
+                    size -= loop;
+                    break;
+
+                case 3:
+                case 4:
+                    NEED_SRC(((offset & 0x3F) == 3) ? 2 : 3);
+                    num = *src++;
+
+                    if ((offset & 0x3F) == 3) {
+                        loop = *src++;
+                        loop = (loop == 0) ? 0x100 : loop;
+                    } else {
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+                        loop = (loop == 0) ? 0x10000 : loop;
+                    }
+
+                    NEED_DST(loop);
+
+                    for (j = 0; j < loop; j++) {
+                        *dst++ = num;
+                    }
+
+                    size -= loop;
+                    break;
+
+                case 5:
+                case 6:
+                    NEED_SRC(((offset & 0x3F) == 5) ? 3 : 4);
+                    num = *src++;
+                    step = *src++;
+
+                    if ((offset & 0x3F) == 5) {
+                        loop = *src++;
+                        loop = (loop == 0) ? 0x100 : loop;
+                    } else {
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+                        loop = (loop == 0) ? 0x10000 : loop;
+                    }
+
+                    NEED_DST(loop);
+
+                    for (j = 0; j < loop; j++) {
+                        *dst++ = num;
+                        num += step;
+                    }
+
+                    size -= loop;
+                    break;
+                }
+            }
+        } else {
+            NEED_SRC(1);
+            offset = (offset << 8) | *src++;
+            loop = offset & 0xF;
+
+            if (loop == 0) {
+                loop = 0x10;
+            }
+
+            offset = (offset >> 4) & 0x7FF;
+
+            if (offset == 0) {
+                offset = 0x800;
+            }
+
+            NEED_DST(loop);
+            NEED_DIC(offset);
+            dic = dst - offset;
+
+            for (j = 0; j < loop; j++) {
+                *dst++ = *dic++;
+            }
+
+            size -= loop;
+        }
+    }
+
+#undef NEED_SRC
+#undef NEED_DST
+#undef NEED_DIC
+
+    return size == 0;
+}
+
+static s32 decode_reference(const u8* src, u8* dst, s32 size) {
+    return decode_reference_impl(src, NULL, dst, size, false);
+}
+
+static s32 decode_reference_checked(const u8* src, s32 src_size, u8* dst, s32 size) {
+    return decode_reference_impl(src, src + src_size, dst, size, true);
+}
+
+static s32 run_reference(const Chunk* chunk, u8* dst) {
+    return decode_reference(chunk->src, dst, chunk->dst_size);
+}
+
+static s32 run_size_check(const Chunk* chunk, u8* dst) {
+    return decLZ77withSizeCheck((u8*)chunk->src, dst, chunk->dst_size);
+}
+
+static s32 run_bounds_check(const Chunk* chunk, u8* dst) {
+    return decLZ77withBoundsCheck(chunk->src, chunk->src_size, dst, chunk->dst_size);
+}
+
+static Uint32 read_u32_be(const u8* p) {
+    return ((Uint32)p[0] << 24) | ((Uint32)p[1] << 16) | ((Uint32)p[2] << 8) | p[3];
+}
+
+static void add_chunk(ChunkList* list, const Chunk* chunk) {
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity > 0) ? list->capacity * 2 : 256;
+        list->items = SDL_realloc(list->items, list->capacity * sizeof(Chunk));
+    }
+
+    list->items[list->count] = *chunk;
+    list->count += 1;
+}
+
+static void free_chunks(ChunkList* list) {
+    for (int i = 0; i < list->count; i++) {
+        SDL_free(list->items[i].src);
+    }
+
+    SDL_free(list->items);
+    SDL_zerop(list);
+}
+
+/// Read a whole file of the archive.
+/// @return The contents, `NULL` if the read failed. Free with `SDL_free`.
+static u8* read_file(int file_num) {
+    const AFSHandle handle = AFS_Open(file_num);
+
+    if (handle == AFS_NONE) {
+        return NULL;
+    }
+
+    const unsigned int sectors = AFS_GetSectorCount(handle);
+    u8* data = SDL_malloc((size_t)sectors * 2048);
+
+    if (data != NULL) {
+        AFS_ReadSync(handle, sectors, data);
+
+        if (AFS_GetState(handle) != AFS_READ_STATE_FINISHED) {
+            SDL_free(data);
+            data = NULL;
+        }
+    }
+
+    AFS_Close(handle);
+    return data;
+}
+
+/// Chunks are found by their header rather than by walking chunk lists, so that none are
+/// missed whatever the layout of the file around them.
+static void find_chunks(ChunkList* list, int file_num, const u8* data, unsigned int size) {
+    for (unsigned int offset = 0; (offset + CHUNK_HEADER_SIZE) <= size; offset += 4) {
+        const u8* header = data + offset;
+
+        if (SDL_memcmp(header, "pCMP", 4) != 0) {
+            continue;
+        }
+
+        const Uint32 chunk_size = read_u32_be(header + 4);
+        const Uint32 exp_size = read_u32_be(header + 12);
+
+        if ((chunk_size <= CHUNK_HEADER_SIZE) || (chunk_size > (size - offset)) || ((header[10] & 3) != 1) ||
+            (exp_size == 0) || (exp_size > CHUNK_EXP_SIZE_MAX)) {
+            continue;
+        }
+
+        Chunk chunk = { .file_num = file_num,
+                        .file_offset = offset,
+                        .src_size = chunk_size - CHUNK_HEADER_SIZE,
+                        .dst_size = exp_size };
+
+        chunk.src = SDL_malloc(chunk.src_size);
+        SDL_memcpy(chunk.src, header + CHUNK_HEADER_SIZE, chunk.src_size);
+        add_chunk(list, &chunk);
+    }
+}
+
+/// Check that both entry points decode the chunk exactly like the reference. Headers that the
+/// reference can't decode within the chunk are taken as byte patterns that only look like one,
+/// but the bounds checked decoder must reject them too.
+/// @return `false` if the chunk should be left out of the benchmark.
+static bool verify_chunk(const Chunk* chunk, bool* passed) {
+    u8* expected = SDL_malloc(chunk->dst_size);
+    u8* actual = SDL_malloc(chunk->dst_size);
+    const s32 reference = decode_reference_checked(chunk->src, chunk->src_size, expected, chunk->dst_size);
+    const s32 bounds = run_bounds_check(chunk, actual);
+    bool accepted = false;
+
+    if (!reference) {
+        if (bounds) {
+            SDL_Log("[lz77] file %d offset 0x%X: accepted by the bounds checked decoder, but not by the reference",
+                    chunk->file_num,
+                    chunk->file_offset);
+            *passed = false;
+        }
+    } else if (!bounds) {
+        SDL_Log("[lz77] file %d offset 0x%X: rejected by the bounds checked decoder",
+                chunk->file_num,
+                chunk->file_offset);
+        *passed = false;
+    } else if (SDL_memcmp(expected, actual, chunk->dst_size) != 0) {
+        SDL_Log("[lz77] file %d offset 0x%X: bounds checked output differs", chunk->file_num, chunk->file_offset);
+        *passed = false;
+    } else if (!run_size_check(chunk, actual) || (SDL_memcmp(expected, actual, chunk->dst_size) != 0)) {
+        SDL_Log("[lz77] file %d offset 0x%X: size checked output differs", chunk->file_num, chunk->file_offset);
+        *passed = false;
+    } else {
+        accepted = true;
+    }
+
+    SDL_free(expected);
+    SDL_free(actual);
+    return accepted;
+}
+
+static void benchmark(const char* name, Decoder decoder, const ChunkList* list, u8* dst) {
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+        for (int i = 0; i < list->count; i++) {
+            decoder(&list->items[i], dst);
+        }
+    }
+
+    const double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    const double megabytes = (double)list->dst_bytes * BENCHMARK_PASSES / (1024.0 * 1024.0);
+
+    SDL_Log("[lz77] %-14s %8.1f MB/s", name, (seconds > 0) ? megabytes / seconds : 0.0);
+}
+
+static s32 random_below(Uint64* rng, s32 n) {
+    return SDL_rand_r(rng, n);
+}
+
+static s32 random_count(Uint64* rng, s32 max, s32 remaining) {
+    return 1 + random_below(rng, SDL_min(max, remaining));
+}
+
+/// Encode random operations until they decode to `size` bytes, and decode them into `expected`
+/// along the way. Every kind of operation comes up, including overlapping and stepped matches,
+/// counts that wrap to their maximum and opcodes that output nothing.
+/// @return Size of the stream. `src` must hold `FUZZ_SRC_SIZE(size)` bytes.
+static s32 generate_stream(Uint64* rng, u8* src, u8* expected, s32 size) {
+    s32 src_size = 0;
+    s32 written = 0;
+    int unknown_ops = 0;
+
+    while (written < size) {
+        const s32 remaining = size - written;
+        s32 op = random_below(rng, 8);
+
+        if ((op >= 5) && (written == 0)) {
+            op = 0;
+        }
+
+        switch (op) {
+        case 0:
+        case 1: {
+            const bool wide = (op == 1);
+            const s32 loop = random_count(rng, wide ? 0x10000 : 0x100, remaining);
+
+            src[src_size++] = wide ? 0x82 : 0x81;
+
+            if (wide) {
+                src[src_size++] = (loop >> 8) & 0xFF;
+            }
+
+            src[src_size++] = loop & 0xFF;
+
+            for (s32 j = 0; j < loop; j++) {
+                src[src_size] = random_below(rng, 256);
+                expected[written++] = src[src_size++];
+            }
+
+            break;
+        }
+
+        case 2:
+        case 3: {
+            const bool wide = random_below(rng, 2);
+            const bool ramp = (op == 3);
+            const s32 loop = random_count(rng, wide ? 0x10000 : 0x100, remaining);
+            u8 num = random_below(rng, 256);
+            const u8 step = ramp ? random_below(rng, 256) : 0;
+
+            src[src_size++] = 0x80 | ((ramp ? 5 : 3) + wide);
+            src[src_size++] = num;
+
+            if (ramp) {
+                src[src_size++] = step;
+            }
+
+            if (wide) {
+                src[src_size++] = (loop >> 8) & 0xFF;
+            }
+
+            src[src_size++] = loop & 0xFF;
+
+            for (s32 j = 0; j < loop; j++) {
+                expected[written++] = num;
+                num += step;
+            }
+
+            break;
+        }
+
+        case 4:
+            if (unknown_ops < FUZZ_UNKNOWN_OPS_MAX) {
+                const u8 unknown[] = { 0, 7, 0x20, 0x3F };
+
+                src[src_size++] = 0x80 | unknown[random_below(rng, SDL_arraysize(unknown))];
+                unknown_ops += 1;
+            }
+
+            break;
+
+        case 5:
+        case 6: {
+            const s32 loop = random_count(rng, 0x10, remaining);
+            const s32 offset = random_count(rng, 0x800, written);
+            const u16 word = ((offset & 0x7FF) << 4) | (loop & 0xF);
+
+            src[src_size++] = word >> 8;
+            src[src_size++] = word & 0xFF;
+
+            for (s32 j = 0; j < loop; j++, written++) {
+                expected[written] = expected[written - offset];
+            }
+
+            break;
+        }
+
+        case 7: {
+            const s32 loop = random_count(rng, 0x80, remaining);
+            const s32 offset = random_count(rng, 0x4000, written);
+            const bool stepped = random_below(rng, 2);
+            const u8 step = stepped ? random_below(rng, 256) : 0;
+
+            src[src_size++] = 0xC0 | ((offset >> 8) & 0x3F);
+            src[src_size++] = offset & 0xFF;
+            src[src_size++] = (stepped ? 0x80 : 0) | (loop & 0x7F);
+
+            if (stepped) {
+                src[src_size++] = step;
+            }
+
+            for (s32 j = 0; j < loop; j++, written++) {
+                expected[written] = expected[written - offset] + step;
+            }
+
+            break;
+        }
+        }
+    }
+
+    return src_size;
+}
+
+/// Flip random bytes, or cut the stream short.
+static s32 damage_stream(Uint64* rng, u8* src, s32 src_size) {
+    if ((src_size > 1) && (random_below(rng, 4) == 0)) {
+        return random_below(rng, src_size);
+    }
+
+    const int flips = 1 + random_below(rng, 4);
+
+    for (int i = 0; i < flips; i++) {
+        src[random_below(rng, src_size)] ^= 1 + random_below(rng, 255);
+    }
+
+    return src_size;
+}
+
+/// Decode a stream with the bounds checked decoder, in a destination with guard bytes after it.
+/// Accepted streams must decode like the reference, and like `expected` when it's given.
+static bool fuzz_one(const u8* stream, s32 src_size, s32 dst_size, const u8* expected) {
+    u8* src = SDL_malloc(SDL_max(src_size, 1));
+    u8* dst = SDL_malloc(dst_size + FUZZ_GUARD_SIZE);
+    u8* reference = SDL_malloc(dst_size);
+    bool passed = true;
+
+    SDL_memcpy(src, stream, src_size);
+    SDL_memset(dst + dst_size, FUZZ_GUARD_BYTE, FUZZ_GUARD_SIZE);
+
+    const s32 accepted = decLZ77withBoundsCheck(src, src_size, dst, dst_size);
+
+    for (int i = 0; i < FUZZ_GUARD_SIZE; i++) {
+        passed &= (dst[dst_size + i] == FUZZ_GUARD_BYTE);
+    }
+
+    if (expected != NULL) {
+        passed &= accepted && (SDL_memcmp(dst, expected, dst_size) == 0);
+    }
+
+    if (passed && accepted) {
+        passed = decode_reference(src, reference, dst_size) && (SDL_memcmp(dst, reference, dst_size) == 0);
+    }
+
+    SDL_free(src);
+    SDL_free(dst);
+    SDL_free(reference);
+    return passed;
+}
+
+static bool fuzz(const ChunkList* list, int iterations) {
+    Uint64 rng = SDL_GetPerformanceCounter();
+    u8* stream = SDL_malloc(FUZZ_SRC_SIZE(FUZZ_DST_SIZE_MAX));
+    u8* expected = SDL_malloc(FUZZ_DST_SIZE_MAX);
+    int failures = 0;
+
+    SDL_Log("[lz77] fuzzing %d streams, seed 0x%016" SDL_PRIX64, iterations, rng);
+
+    for (int i = 0; i < iterations; i++) {
+        const bool from_archive = (list->count > 0) && (random_below(&rng, 4) == 0);
+        s32 src_size;
+        s32 dst_size;
+
+        if (from_archive) {
+            const Chunk* chunk = &list->items[random_below(&rng, list->count)];
+
+            if ((chunk->dst_size > FUZZ_DST_SIZE_MAX) || (chunk->src_size > FUZZ_SRC_SIZE(FUZZ_DST_SIZE_MAX))) {
+                continue;
+            }
+
+            SDL_memcpy(stream, chunk->src, chunk->src_size);
+            src_size = chunk->src_size;
+            dst_size = chunk->dst_size;
+        } else {
+            // Small sizes now and then, to hit the edges of every operation
+            dst_size = random_count(&rng, random_below(&rng, 2) ? 64 : FUZZ_DST_SIZE_MAX, FUZZ_DST_SIZE_MAX);
+            src_size = generate_stream(&rng, stream, expected, dst_size);
+
+            if (!fuzz_one(stream, src_size, dst_size, expected)) {
+                failures += 1;
+                continue;
+            }
+        }
+
+        src_size = damage_stream(&rng, stream, src_size);
+
+        if (!fuzz_one(stream, src_size, dst_size, NULL)) {
+            failures += 1;
+        }
+    }
+
+    SDL_free(stream);
+    SDL_free(expected);
+    SDL_Log("[lz77] fuzzing: %d failures", failures);
+    return failures == 0;
+}
+
+bool LZ77Check_Run(int fuzz_iterations) {
+    ChunkList list = { 0 };
+    bool passed = true;
+    s32 dst_size_max = 0;
+
+    for (unsigned int file_num = 0; file_num < AFS_GetFileCount(); file_num++) {
+        u8* data = read_file(file_num);
+
+        if (data == NULL) {
+            SDL_Log("[lz77] couldn't read file %u", file_num);
+            passed = false;
+            continue;
+        }
+
+        find_chunks(&list, file_num, data, AFS_GetSize(file_num));
+        SDL_free(data);
+    }
+
+    // Keep only the chunks every decoder can run on
+    int accepted = 0;
+
+    for (int i = 0; i < list.count; i++) {
+        Chunk* chunk = &list.items[i];
+
+        if (!verify_chunk(chunk, &passed)) {
+            SDL_free(chunk->src);
+            list.skipped += 1;
+            continue;
+        }
+
+        list.dst_bytes += chunk->dst_size;
+        dst_size_max = SDL_max(dst_size_max, chunk->dst_size);
+        list.items[accepted++] = *chunk;
+    }
+
+    list.count = accepted;
+    SDL_Log("[lz77] %d chunks match the reference, %d skipped | %.1f MB decoded",
+            list.count,
+            list.skipped,
+            list.dst_bytes / (1024.0 * 1024.0));
+
+    if (list.count > 0) {
+        u8* dst = SDL_malloc(dst_size_max);
+
+        benchmark("reference", run_reference, &list, dst);
+        benchmark("size check", run_size_check, &list, dst);
+        benchmark("bounds check", run_bounds_check, &list, dst);
+        SDL_free(dst);
+    }
+
+    passed &= fuzz(&list, fuzz_iterations);
+    free_chunks(&list);
+    SDL_Log("[lz77] %s", passed ? "passed" : "FAILED");
+    return passed;
+}
@@ -0,0 +1,15 @@
+#ifndef PORT_LZ77_CHECK_H
+#define PORT_LZ77_CHECK_H
+
+#include <stdbool.h>
+
+#define LZ77_CHECK_FUZZ_ITERATIONS_DEFAULT 100000
+
+/// Decode every LZ77 compressed pCMP chunk of the archive with the original byte by byte decoder
+/// and with both entry points of `Lz77Dec.c`, compare the results and log the throughput of each.
+/// Then feed `fuzz_iterations` generated and damaged streams to the bounds checked decoder.
+/// The archive must have been opened with `AFS_Init`.
+/// @return `true` if every check passed.
+bool LZ77Check_Run(int fuzz_iterations);
+
+#endif
@@ -1,5 +1,6 @@
 #include "port/sdl/sdl_app.h"
 #include "common.h"
+#include "netplay/netplay.h"
 #include "port/config.h"
 #include "port/sdl/sdl_debug_text.h"
 #include "port/sdl/sdl_game_renderer.h"
@@ -8,10 +9,13 @@
 #include "port/sound/adx.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Game/main.h"
+#include "sf33rd/Source/Game/rendering/mtrans.h"
 
 #include <SDL3/SDL.h>
 
 #define FRAME_END_TIMES_MAX 30
+#define PRESENT_STATS_FRAMES 120
+#define FRAME_DELAY_MAX_MS 15
 
 typedef enum ScaleMode {
     SCALEMODE_NEAREST,
@@ -21,12 +25,32 @@ typedef enum ScaleMode {
     SCALEMODE_INTEGER,
 } ScaleMode;
 
+typedef enum FramePacing {
+    FRAME_PACING_SLEEP,  // Sleep until the deadline
+    FRAME_PACING_HYBRID, // Sleep until shortly before the deadline, then spin
+} FramePacing;
+
+/// Present-to-present intervals over a window of frames.
+typedef struct PresentStats {
+    Uint64 last_present_ns;
+    int count;
+    double sum_ms;
+    double sum_squares_ms;
+    double max_ms;
+
+    // Results of the last complete window
+    double average_ms;
+    double jitter_ms; // Standard deviation
+    double worst_ms;
+} PresentStats;
+
 static const char* app_name = "Street Fighter III: 3rd Strike";
 static const float display_target_ratio = 4.0 / 3.0;
 static const int window_min_width = 384;
 static const int window_min_height = (int)(window_min_width / display_target_ratio);
 static const double target_fps = 59.59949;
 static const Uint64 target_frame_time_ns = 1000000000.0 / target_fps;
+static const Uint64 pacing_spin_ns = 2000000; // Sleeping is only accurate to about a millisecond or two
 
 SDL_Window* window = NULL;
 static SDL_Renderer* renderer = NULL;
@@ -34,6 +58,10 @@ static SDL_Texture* screen_texture = NULL;
 static ScaleMode scale_mode = SCALEMODE_SOFT_LINEAR;
 
 static Uint64 frame_deadline = 0;
+static double frame_time_scale = 1.0;
+static FramePacing frame_pacing = FRAME_PACING_SLEEP;
+static Uint64 frame_delay_ns = 0;
+static PresentStats present_stats = { 0 };
 static Uint64 frame_end_times[FRAME_END_TIMES_MAX];
 static int frame_end_times_index = 0;
 static bool frame_end_times_filled = false;
@@ -41,6 +69,7 @@ static double fps = 0;
 static Uint64 frame_counter = 0;
 
 static bool should_save_screenshot = false;
+static bool pipelined_rendering = false;
 static Uint64 last_mouse_motion_time = 0;
 static const int mouse_hide_delay_ms = 2000; // 2 seconds
 
@@ -101,9 +130,33 @@ static void init_scalemode() {
     }
 }
 
+static void init_frame_pacing() {
+    const char* raw_frame_pacing = Config_GetString(CFG_KEY_FRAME_PACING);
+
+    if ((raw_frame_pacing != NULL) && (SDL_strcmp(raw_frame_pacing, "hybrid") == 0)) {
+        frame_pacing = FRAME_PACING_HYBRID;
+    } else {
+        frame_pacing = FRAME_PACING_SLEEP;
+    }
+
+    const int frame_delay_ms = SDL_clamp(Config_GetInt(CFG_KEY_FRAME_DELAY), 0, FRAME_DELAY_MAX_MS);
+    frame_delay_ns = SDL_MS_TO_NS(frame_delay_ms);
+}
+
+static SDLGameRenderer_Backend render_backend() {
+    const char* raw_backend = Config_GetString(CFG_KEY_RENDER_BACKEND);
+
+    if ((raw_backend != NULL) && (SDL_strcmp(raw_backend, "cpu") == 0)) {
+        return SDL_GAME_RENDERER_BACKEND_CPU;
+    }
+
+    return SDL_GAME_RENDERER_BACKEND_GPU;
+}
+
 int SDLApp_Init() {
     Config_Init();
     init_scalemode();
+    init_frame_pacing();
 
     SDL_SetAppMetadata(app_name, "0.1", NULL);
     SDL_SetHint(SDL_HINT_VIDEO_WAYLAND_PREFER_LIBDECOR, "1");
@@ -143,7 +196,9 @@ int SDLApp_Init() {
     SDLMessageRenderer_Initialize(renderer);
 
     // Initialize game renderer
-    SDLGameRenderer_Init(renderer);
+    SDLGameRenderer_Init(renderer, render_backend());
+    SDLGameRenderer_SetTextureCacheBudget((size_t)SDL_max(Config_GetInt(CFG_KEY_TEXTURE_CACHE_MB), 0) * 1024 * 1024);
+    pipelined_rendering = Config_GetBool(CFG_KEY_PIPELINED_RENDERING);
 
 #if defined(DEBUG)
     // Initialize debug text renderer
@@ -160,6 +215,7 @@ int SDLApp_Init() {
 }
 
 void SDLApp_Quit() {
+    SDLGameRenderer_Quit();
     Config_Destroy();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -323,6 +379,60 @@ static void note_frame_end_time() {
     }
 }
 
+static void note_present_time() {
+    PresentStats* stats = &present_stats;
+    const Uint64 now = SDL_GetTicksNS();
+
+    if (stats->last_present_ns != 0) {
+        const double interval_ms = (now - stats->last_present_ns) / 1e6;
+        stats->count += 1;
+        stats->sum_ms += interval_ms;
+        stats->sum_squares_ms += interval_ms * interval_ms;
+        stats->max_ms = SDL_max(stats->max_ms, interval_ms);
+    }
+
+    stats->last_present_ns = now;
+
+    if (stats->count < PRESENT_STATS_FRAMES) {
+        return;
+    }
+
+    stats->average_ms = stats->sum_ms / stats->count;
+    stats->jitter_ms = SDL_sqrt(SDL_max(stats->sum_squares_ms / stats->count - stats->average_ms * stats->average_ms, 0));
+    stats->worst_ms = stats->max_ms;
+    stats->count = 0;
+    stats->sum_ms = 0;
+    stats->sum_squares_ms = 0;
+    stats->max_ms = 0;
+}
+
+/// Block until `deadline`. Hybrid pacing sleeps for most of the time and spins for the rest,
+/// because waking up from a sleep can be late by the OS timer slack.
+static void wait_until(Uint64 deadline) {
+    Uint64 now = SDL_GetTicksNS();
+
+    if (now >= deadline) {
+        return;
+    }
+
+    switch (frame_pacing) {
+    case FRAME_PACING_SLEEP:
+        SDL_DelayNS(deadline - now);
+        break;
+
+    case FRAME_PACING_HYBRID:
+        if (deadline - now > pacing_spin_ns) {
+            SDL_DelayNS(deadline - now - pacing_spin_ns);
+        }
+
+        while (SDL_GetTicksNS() < deadline) {
+            SDL_CPUPauseInstruction();
+        }
+
+        break;
+    }
+}
+
 static void update_fps() {
     if (!frame_end_times_filled) {
         return;
@@ -347,8 +457,19 @@ static void save_texture(SDL_Texture* texture, const char* filename) {
     SDL_DestroySurface(rendered_surface);
 }
 
+#if defined(DEBUG)
+static void render_centered_debug_text(int window_width, float y, const char* text) {
+    const int text_width = SDL_strlen(text) * SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+    SDL_RenderDebugText(renderer, (window_width - text_width) / 2, y, text);
+}
+#endif
+
 void SDLApp_EndFrame() {
-    // Run sound processing
+    if (!pipelined_rendering) {
+        SDLGameRenderer_SubmitFrame();
+    }
+
+    // Run sound processing while the render worker prepares the frame
     ADX_ProcessTracks();
 
     // Render
@@ -356,7 +477,13 @@ void SDLApp_EndFrame() {
     SDLGameRenderer_RenderFrame();
 
     if (should_save_screenshot) {
-        save_texture(cps3_canvas, "screenshot_cps3.bmp");
+        const SDL_Surface* software_canvas = SDLGameRenderer_GetSoftwareCanvas();
+
+        if (software_canvas != NULL) {
+            SDL_SaveBMP((SDL_Surface*)software_canvas, "screenshot_cps3.bmp");
+        } else {
+            save_texture(cps3_canvas, "screenshot_cps3.bmp");
+        }
     }
 
     SDL_SetRenderTarget(renderer, screen_texture);
@@ -389,31 +516,82 @@ void SDLApp_EndFrame() {
     SDL_SetRenderScale(renderer, 2, 2);
     SDL_RenderDebugTextFormat(renderer, (window_width / 2) - 88, 2, "FPS: %.3f", fps);
     SDL_SetRenderScale(renderer, 1, 1);
+
+    const SDLGameRenderer_TextureCacheStats* cache_stats = SDLGameRenderer_GetTextureCacheStats();
+    char render_stats[128];
+    SDL_snprintf(render_stats,
+                 sizeof(render_stats),
+                 "Draw calls: %d | Textures: %d, %.1f/%.0f MB, hit %d miss %d evict %d",
+                 SDLGameRenderer_GetDrawCallCount(),
+                 cache_stats->textures,
+                 cache_stats->bytes / (1024.0 * 1024.0),
+                 cache_stats->budget / (1024.0 * 1024.0),
+                 cache_stats->hits,
+                 cache_stats->misses,
+                 cache_stats->evictions);
+    render_centered_debug_text(window_width, 24, render_stats);
+
+    char present_text[96];
+    SDL_snprintf(present_text,
+                 sizeof(present_text),
+                 "Present: %.2f ms, jitter %.3f ms, worst %.2f ms | frame delay %d ms",
+                 present_stats.average_ms,
+                 present_stats.jitter_ms,
+                 present_stats.worst_ms,
+                 (int)(frame_delay_ns / SDL_NS_PER_MS));
+    render_centered_debug_text(window_width, 34, present_text);
+
+    char buffer_stats[128];
+    SDL_snprintf(buffer_stats,
+                 sizeof(buffer_stats),
+                 "Quads: %d, max %d | Sprite chips: max %d, dropped %d | CG cache full: %d",
+                 SDLGameRenderer_GetRenderTaskCount(),
+                 SDLGameRenderer_GetRenderTaskHighWater(),
+                 seqsGetSprMax(),
+                 seqsGetSprDropped(),
+                 mltGetPatCashFullCount());
+    render_centered_debug_text(window_width, 44, buffer_stats);
+
+    const char* netplay_telemetry = Netplay_GetTelemetryOverlay();
+    const char* run_ahead_stats = Netplay_GetRunAheadOverlay();
+
+    if (netplay_telemetry != NULL) {
+        render_centered_debug_text(window_width, 54, netplay_telemetry);
+    } else if (run_ahead_stats != NULL) {
+        render_centered_debug_text(window_width, 54, run_ahead_stats);
+    }
 #endif
 
+    if (frame_deadline == 0) {
+        frame_deadline = SDL_GetTicksNS() + target_frame_time_ns;
+    }
+
+    // With a frame delay, frames are presented on a fixed schedule and the next one
+    // starts late into its slot, so that input is read as close to the present as possible
+    if (frame_delay_ns > 0) {
+        wait_until(frame_deadline);
+    }
+
     SDL_RenderPresent(renderer);
+    note_present_time();
 
     // Cleanup
     SDLGameRenderer_EndFrame();
     should_save_screenshot = false;
 
+    if (pipelined_rendering) {
+        // This frame gets drawn at the end of the next one and is prepared while that one is simulated
+        SDLGameRenderer_SubmitFrame();
+    }
+
     // Handle cursor hiding
     hide_cursor_if_needed();
 
     // Do frame pacing
-    Uint64 now = SDL_GetTicksNS();
+    wait_until(frame_deadline + frame_delay_ns);
+    const Uint64 now = SDL_GetTicksNS();
 
-    if (frame_deadline == 0) {
-        frame_deadline = now + target_frame_time_ns;
-    }
-
-    if (now < frame_deadline) {
-        Uint64 sleep_time = frame_deadline - now;
-        SDL_DelayNS(sleep_time);
-        now = SDL_GetTicksNS();
-    }
-
-    frame_deadline += target_frame_time_ns;
+    frame_deadline += target_frame_time_ns * frame_time_scale;
 
     // If we fell behind by more than one frame, resync to avoid spiraling
     if (now > frame_deadline + target_frame_time_ns) {
@@ -426,6 +604,10 @@ void SDLApp_EndFrame() {
     update_fps();
 }
 
+void SDLApp_SetFrameTimeScale(double scale) {
+    frame_time_scale = scale;
+}
+
 void SDLApp_Exit() {
     SDL_Event quit_event;
     quit_event.type = SDL_EVENT_QUIT;
@@ -1,5 +1,6 @@
 #include "port/sdl/sdl_game_renderer.h"
 #include "common.h"
+#include "port/sdl/sdl_soft_rasterizer.h"
 #include "sf33rd/AcrSDK/ps2/flps2etc.h"
 #include "sf33rd/AcrSDK/ps2/flps2render.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
@@ -12,35 +13,111 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define RENDER_TASK_MAX 1024
+#define RENDER_TASKS_INITIAL 1024 // Lists grow past this when a frame needs more
+#define TEXTURES_TO_DESTROY_INITIAL 64
+
+/// What quads sample: an `SDL_Texture` with the GPU backend, an ARGB8888 `SDL_Surface` with the CPU one.
+typedef void RendererTexture;
 
 typedef struct RenderTask {
-    SDL_Texture* texture;
+    RendererTexture* texture;
     SDL_Vertex vertices[4];
     float z;
     int index;
 } RenderTask;
 
+typedef struct CachedTexture {
+    RendererTexture* texture;
+    SDL_Rect dirty; // Part of the surface that changed since it was last uploaded
+
+    Uint32 used_frame;
+
+    // Other textures cached with the same palette, as texture index + 1 (0 ends the list)
+    Uint16 prev;
+    Uint16 next;
+
+    // Neighbours in the LRU list, as cache ids
+    Uint32 lru_prev;
+    Uint32 lru_next;
+} CachedTexture;
+
+/// Consecutive quads in draw order that sample the same texture.
+typedef struct RenderBatch {
+    RendererTexture* texture;
+    int first_vertex;
+    int quad_count;
+} RenderBatch;
+
+/// Everything needed to draw a frame. The game fills one list while the other is prepared and drawn.
+/// Its arrays keep their size from frame to frame and only grow.
+typedef struct RenderList {
+    RenderTask* tasks;
+    int task_count;
+    int task_capacity;
+    int* order;           // Indices of tasks in draw order
+    SDL_Vertex* vertices; // Vertices of tasks in draw order, 4 per task
+    RenderBatch* batches;
+    int batch_count;
+    RendererTexture** textures_to_destroy; // Retired while the game was filling this list
+    int textures_to_destroy_count;
+    int textures_to_destroy_capacity;
+    Uint32 clear_color;
+    Uint32 frame;
+} RenderList;
+
+/// Thread that sorts and batches submitted lists.
+typedef struct RenderWorker {
+    SDL_Thread* thread;
+    SDL_Semaphore* start;
+    SDL_Semaphore* done;
+    RenderList* list; // NULL tells the thread to exit
+} RenderWorker;
+
+/// Textures in `texture_cache` from the most to the least recently used.
+typedef struct TextureLRU {
+    Uint32 head;
+    Uint32 tail;
+    size_t budget; // Bytes, 0 for no limit
+    SDLGameRenderer_TextureCacheStats stats;
+} TextureLRU;
+
 SDL_Texture* cps3_canvas = NULL;
 
 static const int cps3_width = 384;
 static const int cps3_height = 224;
 
 static SDL_Renderer* _renderer = NULL;
+static SDLGameRenderer_Backend backend = SDL_GAME_RENDERER_BACKEND_GPU;
+static SDL_Surface* soft_canvas = NULL; // What the CPU backend draws into
 static SDL_Surface* surfaces[FL_TEXTURE_MAX] = { NULL };
 static SDL_Palette* palettes[FL_PALETTE_MAX] = { NULL };
-static SDL_Texture* textures[FL_PALETTE_MAX] = { NULL };
+static RendererTexture* textures[FL_PALETTE_MAX] = { NULL };
 static int texture_count = 0;
-static SDL_Texture* texture_cache[FL_TEXTURE_MAX][FL_PALETTE_MAX + 1] = { { NULL } };
-static SDL_Texture* textures_to_destroy[1024] = { NULL };
-static int textures_to_destroy_count = 0;
-static RenderTask render_tasks[RENDER_TASK_MAX] = { 0 };
-static int render_task_count = 0;
+static CachedTexture texture_cache[FL_TEXTURE_MAX][FL_PALETTE_MAX + 1] = { { { 0 } } };
+static SDL_Rect pending_dirty_rects[FL_TEXTURE_MAX] = { { 0 } };
+static Uint16 palette_users[FL_PALETTE_MAX + 1] = { 0 }; // First texture cached with each palette, as index + 1
+static TextureLRU texture_lru = { 0 };
+static RenderList render_lists[2] = { 0 };
+static RenderList* building_list = &render_lists[0]; // Filled by the game
+static RenderList* submitted_list = NULL;            // Being prepared, or prepared and waiting to be drawn
+static RenderList* drawn_list = NULL;                // Drawn, released at the end of the frame
+static RenderWorker render_worker = { 0 };
+static Uint32 frame_number = 1;   // Frame of building_list
+static Uint32 released_frame = 0; // Last frame whose list was drawn and released
+static Uint64* sort_keys = NULL;    // Only touched by the render worker
+static Uint64* sort_scratch = NULL;
+static int sort_capacity = 0;
+static int* quad_indices = NULL;
+static int quad_indices_capacity = 0; // In quads
+static int draw_call_count = 0;
+static int render_task_count = 0;      // Tasks of the last submitted frame
+static int render_task_high_water = 0; // Most tasks any frame has had
 
 // Debugging
 
 static bool draw_rect_borders = false;
 static bool dump_textures = false;
+static bool benchmark_sorting = false;
 
 static int texture_index = 0;
 
@@ -98,12 +175,12 @@ static void save_texture(const SDL_Surface* surface, const SDL_Palette* palette)
 
 // Textures
 
-static void push_texture(SDL_Texture* texture) {
+static void push_texture(RendererTexture* texture) {
     textures[texture_count] = texture;
     texture_count += 1;
 }
 
-static SDL_Texture* get_texture() {
+static RendererTexture* get_texture() {
     if (texture_count == 0) {
         fatal_error("No textures to get");
     }
@@ -111,23 +188,257 @@ static SDL_Texture* get_texture() {
     return textures[texture_count - 1];
 }
 
-static void push_texture_to_destroy(SDL_Texture* texture) {
-    textures_to_destroy[textures_to_destroy_count] = texture;
-    textures_to_destroy_count += 1;
+// Cache ids pack a texture index and a palette handle, offset by one so that 0 means none
+
+static Uint32 cache_id(int texture_index, int palette_handle) {
+    return texture_index * (FL_PALETTE_MAX + 1) + palette_handle + 1;
 }
 
-static void destroy_textures() {
-    for (int i = 0; i < texture_count; i++) {
-        textures[i] = NULL;
+static CachedTexture* cached_texture_from_id(Uint32 id) {
+    return &texture_cache[0][0] + (id - 1);
+}
+
+static size_t texture_bytes(const RendererTexture* texture) {
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        const SDL_Surface* surface = texture;
+        return (size_t)surface->h * surface->pitch;
     }
 
-    texture_count = 0;
+    const SDL_Texture* gpu_texture = texture;
+    return (size_t)gpu_texture->w * gpu_texture->h * SDL_BYTESPERPIXEL(gpu_texture->format);
+}
 
-    for (int i = 0; i < textures_to_destroy_count; i++) {
-        SDL_DestroyTexture(textures_to_destroy[i]);
+static RendererTexture* create_renderer_texture(SDL_Surface* surface) {
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        return SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
     }
 
-    textures_to_destroy_count = 0;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(_renderer, surface);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+static void destroy_renderer_texture(RendererTexture* texture) {
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        SDL_DestroySurface(texture);
+    } else {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+static void lru_unlink(CachedTexture* cached) {
+    if (cached->lru_prev != 0) {
+        cached_texture_from_id(cached->lru_prev)->lru_next = cached->lru_next;
+    } else {
+        texture_lru.head = cached->lru_next;
+    }
+
+    if (cached->lru_next != 0) {
+        cached_texture_from_id(cached->lru_next)->lru_prev = cached->lru_prev;
+    } else {
+        texture_lru.tail = cached->lru_prev;
+    }
+
+    cached->lru_prev = 0;
+    cached->lru_next = 0;
+}
+
+static void lru_push_front(CachedTexture* cached, Uint32 id) {
+    cached->lru_prev = 0;
+    cached->lru_next = texture_lru.head;
+
+    if (texture_lru.head != 0) {
+        cached_texture_from_id(texture_lru.head)->lru_prev = id;
+    } else {
+        texture_lru.tail = id;
+    }
+
+    texture_lru.head = id;
+}
+
+/// Convert the dirty part of `surface` and copy it into the cached texture.
+static void upload_dirty_rect(CachedTexture* cached, SDL_Surface* surface) {
+    const int bits_per_pixel = SDL_BITSPERPIXEL(surface->format);
+    const SDL_Rect bounds = { .x = 0, .y = 0, .w = surface->w, .h = surface->h };
+    SDL_Rect rect;
+
+    if (!SDL_GetRectIntersection(&cached->dirty, &bounds, &rect)) {
+        SDL_zero(cached->dirty);
+        return;
+    }
+
+    // 4-bit surfaces have two pixels per byte, so the rect has to start on a byte
+    if (bits_per_pixel == 4) {
+        rect.w += rect.x & 1;
+        rect.x &= ~1;
+    }
+
+    Uint8* pixels = (Uint8*)surface->pixels + rect.y * surface->pitch + rect.x * bits_per_pixel / 8;
+    SDL_Surface* region = SDL_CreateSurfaceFrom(rect.w, rect.h, surface->format, pixels, surface->pitch);
+    SDL_SetSurfacePalette(region, SDL_GetSurfacePalette(surface));
+
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        SDL_Surface* expanded = cached->texture;
+        SDL_Surface* converted = SDL_ConvertSurface(region, expanded->format);
+        const int row_size = rect.w * SDL_BYTESPERPIXEL(expanded->format);
+        Uint8* dst = (Uint8*)expanded->pixels + rect.y * expanded->pitch + rect.x * SDL_BYTESPERPIXEL(expanded->format);
+
+        for (int y = 0; y < rect.h; y++) {
+            SDL_memcpy(dst + y * expanded->pitch, (Uint8*)converted->pixels + y * converted->pitch, row_size);
+        }
+
+        SDL_DestroySurface(converted);
+    } else {
+        const SDL_Texture* texture = cached->texture;
+        SDL_Surface* converted = SDL_ConvertSurface(region, texture->format);
+        SDL_UpdateTexture(cached->texture, &rect, converted->pixels, converted->pitch);
+        SDL_DestroySurface(converted);
+    }
+
+    SDL_DestroySurface(region);
+    SDL_zero(cached->dirty);
+}
+
+/// @return `true` if a list that hasn't been released yet may sample the texture.
+static bool is_in_flight(const CachedTexture* cached) {
+    return cached->used_frame > released_frame;
+}
+
+/// Destroy `texture` once every list that may sample it has been drawn.
+static void push_texture_to_destroy(RendererTexture* texture) {
+    RenderList* list = building_list;
+
+    if (list->textures_to_destroy_count == list->textures_to_destroy_capacity) {
+        list->textures_to_destroy_capacity = SDL_max(list->textures_to_destroy_capacity * 2, TEXTURES_TO_DESTROY_INITIAL);
+        list->textures_to_destroy =
+            SDL_realloc(list->textures_to_destroy, list->textures_to_destroy_capacity * sizeof(RendererTexture*));
+
+        if (list->textures_to_destroy == NULL) {
+            fatal_error("Failed to grow the list of textures to destroy");
+        }
+    }
+
+    list->textures_to_destroy[list->textures_to_destroy_count] = texture;
+    list->textures_to_destroy_count += 1;
+}
+
+static void link_cached_texture(int texture_index, int palette_handle) {
+    CachedTexture* cached = &texture_cache[texture_index][palette_handle];
+    const Uint16 head = palette_users[palette_handle];
+
+    lru_push_front(cached, cache_id(texture_index, palette_handle));
+    texture_lru.stats.textures += 1;
+    texture_lru.stats.bytes += texture_bytes(cached->texture);
+
+    cached->prev = 0;
+    cached->next = head;
+
+    if (head != 0) {
+        texture_cache[head - 1][palette_handle].prev = texture_index + 1;
+    }
+
+    palette_users[palette_handle] = texture_index + 1;
+}
+
+/// Destroy the cached texture and drop it from its palette's list and the LRU.
+/// Textures that are still in flight live until the lists that use them are drawn.
+static void retire_cached_texture(int texture_index, int palette_handle) {
+    CachedTexture* cached = &texture_cache[texture_index][palette_handle];
+
+    lru_unlink(cached);
+    texture_lru.stats.textures -= 1;
+    texture_lru.stats.bytes -= texture_bytes(cached->texture);
+
+    if (cached->prev != 0) {
+        texture_cache[cached->prev - 1][palette_handle].next = cached->next;
+    } else {
+        palette_users[palette_handle] = cached->next;
+    }
+
+    if (cached->next != 0) {
+        texture_cache[cached->next - 1][palette_handle].prev = cached->prev;
+    }
+
+    if (is_in_flight(cached)) {
+        push_texture_to_destroy(cached->texture);
+    } else {
+        destroy_renderer_texture(cached->texture);
+    }
+
+    SDL_zerop(cached);
+}
+
+/// Destroy least recently used textures until the cache fits its budget.
+/// Textures that are in flight are kept even if that means going over.
+static void evict_textures() {
+    while ((texture_lru.budget > 0) && (texture_lru.stats.bytes > texture_lru.budget) && (texture_lru.tail != 0)) {
+        const Uint32 id = texture_lru.tail;
+
+        if (is_in_flight(cached_texture_from_id(id))) {
+            break;
+        }
+
+        retire_cached_texture((id - 1) / (FL_PALETTE_MAX + 1), (id - 1) % (FL_PALETTE_MAX + 1));
+        texture_lru.stats.evictions += 1;
+    }
+}
+
+/// Make room for at least `count` tasks in `list`.
+static void reserve_render_tasks(RenderList* list, int count) {
+    if (count <= list->task_capacity) {
+        return;
+    }
+
+    const int capacity = SDL_max(list->task_capacity * 2, count);
+    list->tasks = SDL_realloc(list->tasks, capacity * sizeof(RenderTask));
+    list->order = SDL_realloc(list->order, capacity * sizeof(int));
+    list->vertices = SDL_realloc(list->vertices, capacity * 4 * sizeof(SDL_Vertex));
+    list->batches = SDL_realloc(list->batches, capacity * sizeof(RenderBatch));
+
+    if ((list->tasks == NULL) || (list->order == NULL) || (list->vertices == NULL) || (list->batches == NULL)) {
+        fatal_error("Failed to grow the render list to %d tasks", capacity);
+    }
+
+    list->task_capacity = capacity;
+}
+
+static void free_render_list(RenderList* list) {
+    SDL_free(list->tasks);
+    SDL_free(list->order);
+    SDL_free(list->vertices);
+    SDL_free(list->batches);
+    SDL_free(list->textures_to_destroy);
+    SDL_zerop(list);
+}
+
+/// Make sure `quad_indices` covers batches of up to `quads` quads.
+static void reserve_quad_indices(int quads) {
+    if (quads <= quad_indices_capacity) {
+        return;
+    }
+
+    const int capacity = SDL_max(quad_indices_capacity * 2, quads);
+    quad_indices = SDL_realloc(quad_indices, capacity * 6 * sizeof(int));
+
+    if (quad_indices == NULL) {
+        fatal_error("Failed to grow the quad index table to %d quads", capacity);
+    }
+
+    // Vertices of each batch start at 0, so the same indices work for all of them
+    for (int i = quad_indices_capacity; i < capacity; i++) {
+        const int base = i * 4;
+        int* indices = &quad_indices[i * 6];
+
+        indices[0] = base + 0;
+        indices[1] = base + 1;
+        indices[2] = base + 2;
+        indices[3] = base + 1;
+        indices[4] = base + 2;
+        indices[5] = base + 3;
+    }
+
+    quad_indices_capacity = capacity;
 }
 
 static void push_render_task(RenderTask* task) {
@@ -135,13 +446,9 @@ static void push_render_task(RenderTask* task) {
         printf("⚠️ Requesting a render task when no rendering is allowed is a programmer error!\n");
     }
 
-    memcpy(&render_tasks[render_task_count], task, sizeof(RenderTask));
-    render_task_count += 1;
-}
-
-static void clear_render_tasks() {
-    SDL_zeroa(render_tasks);
-    render_task_count = 0;
+    reserve_render_tasks(building_list, building_list->task_count + 1);
+    memcpy(&building_list->tasks[building_list->task_count], task, sizeof(RenderTask));
+    building_list->task_count += 1;
 }
 
 static int compare_render_tasks(const RenderTask* a, const RenderTask* b) {
@@ -161,6 +468,211 @@ static int compare_render_tasks(const RenderTask* a, const RenderTask* b) {
     }
 }
 
+/// Map a float to a u32 that sorts the same way when compared as an integer.
+static Uint32 float_sort_key(float value) {
+    Uint32 bits;
+
+    value += 0.0f; // -0 becomes +0, so that they compare equal like they do as floats
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+/// LSD radix sort over bytes. Bytes that are the same in every key (most of z
+/// and the top of the index) are skipped.
+static void radix_sort(Uint64* keys, Uint64* scratch, int count) {
+    int histograms[8][256];
+    Uint64* src = keys;
+    Uint64* dst = scratch;
+
+    SDL_zeroa(histograms);
+
+    for (int i = 0; i < count; i++) {
+        for (int b = 0; b < 8; b++) {
+            histograms[b][(keys[i] >> (b * 8)) & 0xFF] += 1;
+        }
+    }
+
+    for (int b = 0; b < 8; b++) {
+        int* histogram = histograms[b];
+        const int shift = b * 8;
+        int offset = 0;
+
+        if (histogram[(src[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        for (int i = 0; i < 256; i++) {
+            const int bucket_size = histogram[i];
+            histogram[i] = offset;
+            offset += bucket_size;
+        }
+
+        for (int i = 0; i < count; i++) {
+            dst[histogram[(src[i] >> shift) & 0xFF]++] = src[i];
+        }
+
+        Uint64* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != keys) {
+        SDL_memcpy(keys, src, count * sizeof(Uint64));
+    }
+}
+
+/// Fill `list->order` with the same order `compare_render_tasks` produces, without moving the tasks.
+static void sort_render_tasks(RenderList* list) {
+    if (list->task_count == 0) {
+        return;
+    }
+
+    if (list->task_count > sort_capacity) {
+        sort_capacity = list->task_capacity;
+        sort_keys = SDL_realloc(sort_keys, sort_capacity * sizeof(Uint64));
+        sort_scratch = SDL_realloc(sort_scratch, sort_capacity * sizeof(Uint64));
+
+        if ((sort_keys == NULL) || (sort_scratch == NULL)) {
+            fatal_error("Failed to grow the sort keys to %d tasks", sort_capacity);
+        }
+    }
+
+    // Lower z first. On equal z, later tasks go first, which is what eliminates z-fighting.
+    for (int i = 0; i < list->task_count; i++) {
+        const RenderTask* task = &list->tasks[i];
+        sort_keys[i] = ((Uint64)float_sort_key(task->z) << 32) | (Uint32)~(Uint32)task->index;
+    }
+
+    radix_sort(sort_keys, sort_scratch, list->task_count);
+
+    for (int i = 0; i < list->task_count; i++) {
+        list->order[i] = ~(Uint32)sort_keys[i];
+    }
+}
+
+/// Time sorting the list's tasks with `qsort` against `sort_render_tasks`.
+static void benchmark_sort(RenderList* list) {
+    static RenderTask* tasks_copy = NULL;
+    static int tasks_copy_capacity = 0;
+    static Uint64 qsort_ns = 0;
+    static Uint64 radix_ns = 0;
+    static int tasks = 0;
+    static int frames = 0;
+    const int runs = 16;
+
+    if (list->task_count > tasks_copy_capacity) {
+        tasks_copy_capacity = list->task_capacity;
+        tasks_copy = SDL_realloc(tasks_copy, tasks_copy_capacity * sizeof(RenderTask));
+
+        if (tasks_copy == NULL) {
+            fatal_error("Failed to grow the sort benchmark buffer");
+        }
+    }
+
+    for (int i = 0; i < runs; i++) {
+        SDL_memcpy(tasks_copy, list->tasks, list->task_count * sizeof(RenderTask));
+        const Uint64 start = SDL_GetTicksNS();
+        qsort(tasks_copy, list->task_count, sizeof(RenderTask), compare_render_tasks);
+        qsort_ns += SDL_GetTicksNS() - start;
+    }
+
+    for (int i = 0; i < runs; i++) {
+        const Uint64 start = SDL_GetTicksNS();
+        sort_render_tasks(list);
+        radix_ns += SDL_GetTicksNS() - start;
+    }
+
+    for (int i = 0; i < list->task_count; i++) {
+        if (tasks_copy[i].index != list->tasks[list->order[i]].index) {
+            fatal_error("Render task order differs from qsort at %d", i);
+        }
+    }
+
+    tasks += list->task_count;
+    frames += 1;
+
+    if (frames == 600) {
+        SDL_Log("[render] sorted %.1f tasks/frame: qsort %.2f us, radix %.2f us",
+                (double)tasks / frames,
+                qsort_ns / 1000.0 / (frames * runs),
+                radix_ns / 1000.0 / (frames * runs));
+        qsort_ns = 0;
+        radix_ns = 0;
+        tasks = 0;
+        frames = 0;
+    }
+}
+
+/// Lay the vertices out in draw order and group consecutive tasks with the same texture,
+/// so that each group goes out in one call. Triangles within a call are drawn in order,
+/// so this doesn't change what's on top.
+static void batch_render_tasks(RenderList* list) {
+    RenderBatch* batch = NULL;
+
+    list->batch_count = 0;
+
+    for (int i = 0; i < list->task_count; i++) {
+        const RenderTask* task = &list->tasks[list->order[i]];
+
+        if ((batch == NULL) || (batch->texture != task->texture)) {
+            batch = &list->batches[list->batch_count];
+            batch->texture = task->texture;
+            batch->first_vertex = i * 4;
+            batch->quad_count = 0;
+            list->batch_count += 1;
+        }
+
+        SDL_memcpy(&list->vertices[i * 4], task->vertices, sizeof(task->vertices));
+        batch->quad_count += 1;
+    }
+}
+
+/// The color `clear_color` leaves the canvas in, as ARGB.
+static Uint32 canvas_clear_color(Uint32 clear_color) {
+    return ((clear_color >> 24) != SDL_ALPHA_TRANSPARENT) ? clear_color : 0xFF000000;
+}
+
+/// Draw the batched list into `soft_canvas`, for the CPU backend.
+static void rasterize_render_list(const RenderList* list) {
+    SoftRasterizer_Clear(soft_canvas, canvas_clear_color(list->clear_color));
+
+    for (int i = 0; i < list->batch_count; i++) {
+        const RenderBatch* batch = &list->batches[i];
+
+        for (int j = 0; j < batch->quad_count; j++) {
+            SoftRasterizer_DrawQuad(soft_canvas, batch->texture, &list->vertices[batch->first_vertex + j * 4]);
+        }
+    }
+}
+
+static int SDLCALL render_worker_main(void* data) {
+    while (true) {
+        SDL_WaitSemaphore(render_worker.start);
+        RenderList* list = render_worker.list;
+
+        if (list == NULL) {
+            break;
+        }
+
+        sort_render_tasks(list);
+
+        if (benchmark_sorting) {
+            benchmark_sort(list);
+        }
+
+        batch_render_tasks(list);
+
+        // Textures of a submitted list aren't written to until it's released, so they can be read here
+        if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+            rasterize_render_list(list);
+        }
+
+        SDL_SignalSemaphore(render_worker.done);
+    }
+
+    return 0;
+}
+
 // Colors
 
 #define clut_shuf(x) (((x) & ~0x18) | ((((x) & 0x08) << 1) | (((x) & 0x10) >> 1)))
@@ -205,6 +717,51 @@ static void read_color(void* pixels, int index, size_t color_size, SDL_Color* co
     }
 }
 
+/// Read the colors of `fl_palette` from its system buffer.
+/// @return Number of colors.
+static int read_palette_colors(const FLTexture* fl_palette, SDL_Color* colors) {
+    const void* pixels = flPS2GetSystemBuffAdrs(fl_palette->mem_handle);
+    const int color_count = fl_palette->width * fl_palette->height;
+    size_t color_size = 0;
+
+    switch (fl_palette->format) {
+    case SCE_GS_PSMCT32:
+        color_size = 4;
+        break;
+
+    case SCE_GS_PSMCT16:
+        color_size = 2;
+        break;
+
+    default:
+        fatal_error("Unhandled pixel format: %d", fl_palette->format);
+        break;
+    }
+
+    switch (color_count) {
+    case 16:
+        for (int i = 0; i < 16; i++) {
+            read_color(pixels, i, color_size, &colors[i]);
+        }
+
+        break;
+
+    case 256:
+        for (int i = 0; i < 256; i++) {
+            const int color_index = clut_shuf(i);
+            read_color(pixels, color_index, color_size, &colors[i]);
+        }
+
+        break;
+
+    default:
+        fatal_error("Unhandled palette dimensions: %dx%d", fl_palette->width, fl_palette->height);
+        break;
+    }
+
+    return color_count;
+}
+
 #define LERP_FLOAT(a, b, x) ((a) * (1 - (x)) + (b) * (x))
 
 static void lerp_fcolors(SDL_FColor* dest, const SDL_FColor* a, const SDL_FColor* b, float x) {
@@ -216,54 +773,148 @@ static void lerp_fcolors(SDL_FColor* dest, const SDL_FColor* a, const SDL_FColor
 
 // Lifecycle
 
-void SDLGameRenderer_Init(SDL_Renderer* renderer) {
+void SDLGameRenderer_Init(SDL_Renderer* renderer, SDLGameRenderer_Backend renderer_backend) {
     _renderer = renderer;
-    cps3_canvas =
-        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, cps3_width, cps3_height);
-    SDL_SetTextureScaleMode(cps3_canvas, SDL_SCALEMODE_NEAREST);
+    backend = renderer_backend;
+
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        soft_canvas = SDL_CreateSurface(cps3_width, cps3_height, SDL_PIXELFORMAT_ARGB8888);
+
+        // Without a renderer the frames are only available through SDLGameRenderer_GetSoftwareCanvas
+        if (renderer != NULL) {
+            cps3_canvas = SDL_CreateTexture(
+                renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, cps3_width, cps3_height);
+        }
+    } else {
+        cps3_canvas =
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, cps3_width, cps3_height);
+    }
+
+    if (cps3_canvas != NULL) {
+        SDL_SetTextureScaleMode(cps3_canvas, SDL_SCALEMODE_NEAREST);
+    }
+
+    reserve_render_tasks(&render_lists[0], RENDER_TASKS_INITIAL);
+    reserve_render_tasks(&render_lists[1], RENDER_TASKS_INITIAL);
+    reserve_quad_indices(RENDER_TASKS_INITIAL);
+
+    render_worker.start = SDL_CreateSemaphore(0);
+    render_worker.done = SDL_CreateSemaphore(0);
+    render_worker.thread = SDL_CreateThread(render_worker_main, "render worker", NULL);
+
+    if (render_worker.thread == NULL) {
+        fatal_error("Failed to create the render worker: %s", SDL_GetError());
+    }
+}
+
+void SDLGameRenderer_Quit() {
+    render_worker.list = NULL;
+    SDL_SignalSemaphore(render_worker.start);
+    SDL_WaitThread(render_worker.thread, NULL);
+    SDL_DestroySemaphore(render_worker.start);
+    SDL_DestroySemaphore(render_worker.done);
+    SDL_zero(render_worker);
+
+    free_render_list(&render_lists[0]);
+    free_render_list(&render_lists[1]);
+    SDL_free(sort_keys);
+    SDL_free(sort_scratch);
+    SDL_free(quad_indices);
+    SDL_DestroySurface(soft_canvas);
+    soft_canvas = NULL;
+    sort_keys = sort_scratch = NULL;
+    quad_indices = NULL;
+    sort_capacity = quad_indices_capacity = 0;
 }
 
 void SDLGameRenderer_BeginFrame() {
-    // Clear canvas
-    const Uint8 r = (flPs2State.FrameClearColor >> 16) & 0xFF;
-    const Uint8 g = (flPs2State.FrameClearColor >> 8) & 0xFF;
-    const Uint8 b = flPs2State.FrameClearColor & 0xFF;
-    const Uint8 a = flPs2State.FrameClearColor >> 24;
-
-    if (a != SDL_ALPHA_TRANSPARENT) {
-        SDL_SetRenderDrawColor(_renderer, r, g, b, a);
-    } else {
-        SDL_SetRenderDrawColor(_renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    building_list->clear_color = flPs2State.FrameClearColor;
+
+    // Textures set by the previous frame
+    for (int i = 0; i < texture_count; i++) {
+        textures[i] = NULL;
     }
 
+    texture_count = 0;
+    texture_lru.stats.hits = 0;
+    texture_lru.stats.misses = 0;
+    texture_lru.stats.evictions = 0;
+}
+
+void SDLGameRenderer_SubmitFrame() {
+    if (submitted_list != NULL) {
+        fatal_error("Submitting a frame before the previous one was drawn");
+    }
+
+    render_task_count = building_list->task_count;
+    render_task_high_water = SDL_max(render_task_high_water, render_task_count);
+
+    building_list->frame = frame_number;
+    submitted_list = building_list;
+    building_list = (building_list == &render_lists[0]) ? &render_lists[1] : &render_lists[0];
+    frame_number += 1;
+
+    render_worker.list = submitted_list;
+    SDL_SignalSemaphore(render_worker.start);
+}
+
+static void clear_canvas(Uint32 clear_color) {
+    const Uint32 color = canvas_clear_color(clear_color);
+    SDL_SetRenderDrawColor(_renderer, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, color >> 24);
+
     SDL_SetRenderTarget(_renderer, cps3_canvas);
     SDL_RenderClear(_renderer);
 }
 
 void SDLGameRenderer_RenderFrame() {
-    SDL_SetRenderTarget(_renderer, cps3_canvas);
-    qsort(render_tasks, render_task_count, sizeof(RenderTask), compare_render_tasks);
+    RenderList* list = submitted_list;
+
+    if (list == NULL) {
+        return;
+    }
+
+    SDL_WaitSemaphore(render_worker.done);
+    submitted_list = NULL;
+    drawn_list = list;
+
+    if (backend == SDL_GAME_RENDERER_BACKEND_CPU) {
+        if (cps3_canvas != NULL) {
+            SDL_UpdateTexture(cps3_canvas, NULL, soft_canvas->pixels, soft_canvas->pitch);
+        }
+
+        draw_call_count = 0;
+        return;
+    }
 
-    for (int i = 0; i < render_task_count; i++) {
-        const RenderTask* task = &render_tasks[i];
-        const int indices[] = { 0, 1, 2, 1, 2, 3 };
-        SDL_RenderGeometry(_renderer, task->texture, task->vertices, 4, indices, 6);
+    clear_canvas(list->clear_color);
+    reserve_quad_indices(list->task_count);
+
+    for (int i = 0; i < list->batch_count; i++) {
+        const RenderBatch* batch = &list->batches[i];
+        SDL_RenderGeometry(_renderer,
+                           batch->texture,
+                           &list->vertices[batch->first_vertex],
+                           batch->quad_count * 4,
+                           quad_indices,
+                           batch->quad_count * 6);
     }
 
+    draw_call_count = list->batch_count;
+
     if (draw_rect_borders) {
         const SDL_FColor red = { .r = 1, .g = 0, .b = 0, .a = SDL_ALPHA_OPAQUE_FLOAT };
         const SDL_FColor green = { .r = 0, .g = 1, .b = 0, .a = SDL_ALPHA_OPAQUE_FLOAT };
         SDL_FColor border_color;
 
-        for (int i = 0; i < render_task_count; i++) {
-            const RenderTask* task = &render_tasks[i];
+        for (int i = 0; i < list->task_count; i++) {
+            const RenderTask* task = &list->tasks[list->order[i]];
             const float x0 = task->vertices[0].position.x;
             const float y0 = task->vertices[0].position.y;
             const float x1 = task->vertices[3].position.x;
             const float y1 = task->vertices[3].position.y;
             const SDL_FRect border_rect = { .x = x0, .y = y0, .w = (x1 - x0), .h = (y1 - y0) };
 
-            const float lerp_factor = (float)i / (float)(render_task_count - 1);
+            const float lerp_factor = (float)i / (float)(list->task_count - 1);
             lerp_fcolors(&border_color, &red, &green, lerp_factor);
 
             SDL_SetRenderDrawColorFloat(_renderer, border_color.r, border_color.g, border_color.b, border_color.a);
@@ -272,27 +923,124 @@ void SDLGameRenderer_RenderFrame() {
     }
 }
 
+int SDLGameRenderer_GetDrawCallCount() {
+    return draw_call_count;
+}
+
+const SDL_Surface* SDLGameRenderer_GetSoftwareCanvas() {
+    return soft_canvas;
+}
+
+int SDLGameRenderer_GetRenderTaskCount() {
+    return render_task_count;
+}
+
+int SDLGameRenderer_GetRenderTaskHighWater() {
+    return render_task_high_water;
+}
+
 void SDLGameRenderer_EndFrame() {
-    destroy_textures();
-    clear_render_tasks();
+    RenderList* list = drawn_list;
+
+    if (list == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < list->textures_to_destroy_count; i++) {
+        destroy_renderer_texture(list->textures_to_destroy[i]);
+    }
+
+    list->textures_to_destroy_count = 0;
+    list->task_count = 0;
+    list->batch_count = 0;
+    released_frame = list->frame;
+    drawn_list = NULL;
+}
+
+void SDLGameRenderer_SetTextureCacheBudget(size_t bytes) {
+    texture_lru.budget = bytes;
+    texture_lru.stats.budget = bytes;
+    evict_textures();
+}
+
+const SDLGameRenderer_TextureCacheStats* SDLGameRenderer_GetTextureCacheStats() {
+    return &texture_lru.stats;
 }
 
 void SDLGameRenderer_UnlockPalette(unsigned int ph) {
     const int palette_handle = ph;
 
-    if ((palette_handle > 0) && (palette_handle < FL_PALETTE_MAX)) {
+    if ((palette_handle <= 0) || (palette_handle >= FL_PALETTE_MAX)) {
+        return;
+    }
+
+    SDL_Palette* palette = palettes[palette_handle - 1];
+    SDL_Color colors[256];
+    const int color_count = read_palette_colors(&flPalette[palette_handle - 1], colors);
+
+    if ((palette == NULL) || (palette->ncolors != color_count)) {
         SDLGameRenderer_DestroyPalette(palette_handle);
         SDLGameRenderer_CreatePalette(ph << 16);
+        return;
+    }
+
+    // Surfaces share the palette, so only the textures expanded with the old colors are stale.
+    // They get expanded again if and when they're drawn.
+    SDL_SetPaletteColors(palette, colors, 0, color_count);
+
+    for (Uint16 user = palette_users[palette_handle]; user != 0;) {
+        CachedTexture* cached = &texture_cache[user - 1][palette_handle];
+        const SDL_Surface* surface = surfaces[user - 1];
+
+        cached->dirty = (SDL_Rect) { .x = 0, .y = 0, .w = surface->w, .h = surface->h };
+        user = cached->next;
     }
 }
 
-void SDLGameRenderer_UnlockTexture(unsigned int th) {
+void SDLGameRenderer_MarkTextureDirty(unsigned int th, const SDL_Rect* rect) {
     const int texture_handle = th;
 
     if ((texture_handle > 0) && (texture_handle < FL_TEXTURE_MAX)) {
-        SDLGameRenderer_DestroyTexture(texture_handle);
+        SDL_Rect* pending = &pending_dirty_rects[texture_handle - 1];
+        SDL_GetRectUnion(pending, rect, pending);
+    }
+}
+
+void SDLGameRenderer_UnlockTexture(unsigned int th) {
+    const int texture_handle = th;
+
+    if ((texture_handle <= 0) || (texture_handle >= FL_TEXTURE_MAX)) {
+        return;
+    }
+
+    const int texture_index = texture_handle - 1;
+    const SDL_Surface* surface = surfaces[texture_index];
+    SDL_Rect* pending = &pending_dirty_rects[texture_index];
+
+    if (surface == NULL) {
         SDLGameRenderer_CreateTexture(th);
+        SDL_zerop(pending);
+        return;
+    }
+
+    // The surface points straight at the texture's system buffer, so it already has the new pixels.
+    // Only the cached textures need to catch up, which happens the next time they're used.
+    if (SDL_RectEmpty(pending)) {
+        // Nobody said what changed
+        *pending = (SDL_Rect) { .x = 0, .y = 0, .w = surface->w, .h = surface->h };
+    }
+
+    for (int i = 0; i < FL_PALETTE_MAX + 1; i++) {
+        CachedTexture* cached = &texture_cache[texture_index][i];
+
+        if (cached->texture != NULL) {
+            SDL_GetRectUnion(&cached->dirty, pending, &cached->dirty);
+        }
     }
+
+    // Marks that weren't followed by an unlock (e.g. because of a rollback) are kept
+    // until the next one, so that everything that was written eventually gets uploaded
+    SDL_zerop(pending);
 }
 
 void SDLGameRenderer_CreateTexture(unsigned int th) {
@@ -336,67 +1084,27 @@ void SDLGameRenderer_DestroyTexture(unsigned int texture_handle) {
     const int texture_index = texture_handle - 1;
 
     for (int i = 0; i < FL_PALETTE_MAX + 1; i++) {
-        SDL_Texture** texture_p = &texture_cache[texture_index][i];
+        CachedTexture* cached = &texture_cache[texture_index][i];
 
-        if (*texture_p == NULL) {
-            continue;
+        if (cached->texture != NULL) {
+            retire_cached_texture(texture_index, i);
         }
-
-        push_texture_to_destroy(*texture_p);
-        *texture_p = NULL;
     }
 
+    SDL_zero(pending_dirty_rects[texture_index]);
     SDL_DestroySurface(surfaces[texture_index]);
     surfaces[texture_index] = NULL;
 }
 
 void SDLGameRenderer_CreatePalette(unsigned int ph) {
     const int palette_index = HI_16_BITS(ph) - 1;
-    const FLTexture* fl_palette = &flPalette[palette_index];
-    const void* pixels = flPS2GetSystemBuffAdrs(fl_palette->mem_handle);
-    const int color_count = fl_palette->width * fl_palette->height;
     SDL_Color colors[256];
-    size_t color_size = 0;
 
     if (palettes[palette_index] != NULL) {
         fatal_error("Overwriting an existing palette");
     }
 
-    switch (fl_palette->format) {
-    case SCE_GS_PSMCT32:
-        color_size = 4;
-        break;
-
-    case SCE_GS_PSMCT16:
-        color_size = 2;
-        break;
-
-    default:
-        fatal_error("Unhandled pixel format: %d", fl_palette->format);
-        break;
-    }
-
-    switch (color_count) {
-    case 16:
-        for (int i = 0; i < 16; i++) {
-            read_color(pixels, i, color_size, &colors[i]);
-        }
-
-        break;
-
-    case 256:
-        for (int i = 0; i < 256; i++) {
-            const int color_index = clut_shuf(i);
-            read_color(pixels, color_index, color_size, &colors[i]);
-        }
-
-        break;
-
-    default:
-        fatal_error("Unhandled palette dimensions: %dx%d", fl_palette->width, fl_palette->height);
-        break;
-    }
-
+    const int color_count = read_palette_colors(&flPalette[palette_index], colors);
     SDL_Palette* palette = SDL_CreatePalette(color_count);
     SDL_SetPaletteColors(palette, colors, 0, color_count);
     palettes[palette_index] = palette;
@@ -405,15 +1113,8 @@ void SDLGameRenderer_CreatePalette(unsigned int ph) {
 void SDLGameRenderer_DestroyPalette(unsigned int palette_handle) {
     const int palette_index = palette_handle - 1;
 
-    for (int i = 0; i < FL_TEXTURE_MAX; i++) {
-        SDL_Texture** texture_p = &texture_cache[i][palette_handle];
-
-        if (*texture_p == NULL) {
-            continue;
-        }
-
-        push_texture_to_destroy(*texture_p);
-        *texture_p = NULL;
+    while (palette_users[palette_handle] != 0) {
+        retire_cached_texture(palette_users[palette_handle] - 1, palette_handle);
     }
 
     SDL_DestroyPalette(palettes[palette_index]);
@@ -434,24 +1135,35 @@ void SDLGameRenderer_SetTexture(unsigned int th) {
         SDL_SetSurfacePalette(surface, palette);
     }
 
-    SDL_Texture* texture = NULL;
-    const SDL_Texture* cached_texture = texture_cache[texture_handle - 1][palette_handle];
+    CachedTexture* cached = &texture_cache[texture_handle - 1][palette_handle];
+
+    if ((cached->texture != NULL) && !SDL_RectEmpty(&cached->dirty)) {
+        if (is_in_flight(cached)) {
+            // Quads that haven't been drawn yet still need the old pixels
+            retire_cached_texture(texture_handle - 1, palette_handle);
+        } else {
+            upload_dirty_rect(cached, surface);
+        }
+    }
 
-    if (cached_texture != NULL) {
-        texture = cached_texture;
+    if (cached->texture != NULL) {
+        lru_unlink(cached);
+        lru_push_front(cached, cache_id(texture_handle - 1, palette_handle));
+        texture_lru.stats.hits += 1;
     } else {
-        texture = SDL_CreateTextureFromSurface(_renderer, surface);
-        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
-        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-        texture_cache[texture_handle - 1][palette_handle] = texture;
+        cached->texture = create_renderer_texture(surface);
+        link_cached_texture(texture_handle - 1, palette_handle);
+        texture_lru.stats.misses += 1;
     }
 
-    push_texture(texture);
+    cached->used_frame = frame_number;
+    evict_textures();
+    push_texture(cached->texture);
 }
 
 static void draw_quad(const SDLGameRenderer_Vertex* vertices, bool textured) {
     RenderTask task;
-    task.index = render_task_count;
+    task.index = building_list->task_count;
     task.texture = textured ? get_texture() : NULL;
     task.z = flPS2ConvScreenFZ(vertices[0].coord.z);
 
@@ -0,0 +1,273 @@
+#include "port/sdl/sdl_soft_rasterizer.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+#define CANVAS_WIDTH_MAX 384
+
+// Colors are ARGB8888, which is B, G, R, A in memory. Channel math below works
+// in that order, with texels and the canvas at 0-255 and vertex colors at 0-1,
+// and mirrors the GPU path: fragment = texel * color, then
+// rgb = src.rgb * src.a + dst.rgb * (1 - src.a) and a = src.a + dst.a * (1 - src.a).
+
+static Uint32* canvas_row(SDL_Surface* canvas, int y) {
+    return (Uint32*)((Uint8*)canvas->pixels + y * canvas->pitch);
+}
+
+static const Uint32* texture_row(const SDL_Surface* texture, int y) {
+    return (const Uint32*)((const Uint8*)texture->pixels + y * texture->pitch);
+}
+
+static void color_factors(const SDL_FColor* color, float* k) {
+    k[0] = color->b;
+    k[1] = color->g;
+    k[2] = color->r;
+    k[3] = color->a;
+}
+
+#if defined(SDL_SSE2_INTRINSICS)
+/// Same operations in the same order as the scalar version, four channels at a time.
+static Uint32 blend_pixel(Uint32 dst, Uint32 texel, const float* k) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i t = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(texel), zero), zero);
+    const __m128i d = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(dst), zero), zero);
+    const __m128 src = _mm_mul_ps(_mm_cvtepi32_ps(t), _mm_loadu_ps(k));
+    const __m128 alpha = _mm_mul_ps(_mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_ps(1.0f / 255));
+    const __m128 src_factor = _mm_or_ps(_mm_and_ps(alpha, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1))),
+                                        _mm_set_ps(1.0f, 0, 0, 0));
+    const __m128 dst_factor = _mm_sub_ps(_mm_set1_ps(1.0f), alpha);
+    const __m128 out = _mm_add_ps(_mm_mul_ps(src, src_factor), _mm_mul_ps(_mm_cvtepi32_ps(d), dst_factor));
+    __m128i packed = _mm_cvttps_epi32(_mm_add_ps(out, _mm_set1_ps(0.5f)));
+
+    packed = _mm_packs_epi32(packed, packed);
+    packed = _mm_packus_epi16(packed, packed);
+    return (Uint32)_mm_cvtsi128_si32(packed);
+}
+#else
+static Uint32 blend_pixel(Uint32 dst, Uint32 texel, const float* k) {
+    float src[4];
+    Uint32 result = 0;
+
+    for (int i = 0; i < 4; i++) {
+        src[i] = (float)((texel >> (i * 8)) & 0xFF) * k[i];
+    }
+
+    const float alpha = src[3] * (1.0f / 255);
+    const float dst_factor = 1.0f - alpha;
+
+    for (int i = 0; i < 4; i++) {
+        const float src_factor = (i == 3) ? 1.0f : alpha;
+        const float out = src[i] * src_factor + (float)((dst >> (i * 8)) & 0xFF) * dst_factor;
+        result |= (Uint32)(out + 0.5f) << (i * 8);
+    }
+
+    return result;
+}
+#endif
+
+static void blend_into(Uint32* dst, Uint32 texel, const float* k) {
+    // Nothing shows through a transparent texel, and most sprite texels are either that or opaque
+    if ((texel >> 24) == 0) {
+        return;
+    }
+
+    *dst = blend_pixel(*dst, texel, k);
+}
+
+static int texel_coord(float coord, int size) {
+    const int texel = (int)SDL_floorf(coord * size);
+    return SDL_clamp(texel, 0, size - 1);
+}
+
+static bool same_color(const SDL_FColor* a, const SDL_FColor* b) {
+    return (a->r == b->r) && (a->g == b->g) && (a->b == b->b) && (a->a == b->a);
+}
+
+/// @return `true` if the quad is an axis aligned rectangle with one color and a texture
+/// that isn't rotated, which is what every sprite is.
+static bool is_simple_rect(const SDL_Vertex* v) {
+    return (v[0].position.y == v[1].position.y) && (v[2].position.y == v[3].position.y) &&
+           (v[0].position.x == v[2].position.x) && (v[1].position.x == v[3].position.x) &&
+           (v[0].tex_coord.y == v[1].tex_coord.y) && (v[2].tex_coord.y == v[3].tex_coord.y) &&
+           (v[0].tex_coord.x == v[2].tex_coord.x) && (v[1].tex_coord.x == v[3].tex_coord.x) &&
+           same_color(&v[0].color, &v[1].color) && same_color(&v[0].color, &v[2].color) &&
+           same_color(&v[0].color, &v[3].color);
+}
+
+/// Pixels whose centers lie in [`from`, `to`).
+static void covered_pixels(float from, float to, int limit, int* begin, int* end) {
+    *begin = SDL_max((int)SDL_ceilf(from - 0.5f), 0);
+    *end = SDL_min((int)SDL_ceilf(to - 0.5f), limit);
+}
+
+static void draw_rect(SDL_Surface* canvas, const SDL_Surface* texture, const SDL_Vertex* v) {
+    float x0 = v[0].position.x;
+    float x1 = v[1].position.x;
+    float y0 = v[0].position.y;
+    float y1 = v[2].position.y;
+    float s0 = v[0].tex_coord.x;
+    float s1 = v[1].tex_coord.x;
+    float t0 = v[0].tex_coord.y;
+    float t1 = v[2].tex_coord.y;
+    int texels_x[CANVAS_WIDTH_MAX];
+    float k[4];
+    int x_begin;
+    int x_end;
+    int y_begin;
+    int y_end;
+
+    if (x0 > x1) {
+        const float x = x0;
+        const float s = s0;
+        x0 = x1;
+        x1 = x;
+        s0 = s1;
+        s1 = s;
+    }
+
+    if (y0 > y1) {
+        const float y = y0;
+        const float t = t0;
+        y0 = y1;
+        y1 = y;
+        t0 = t1;
+        t1 = t;
+    }
+
+    covered_pixels(x0, x1, SDL_min(canvas->w, CANVAS_WIDTH_MAX), &x_begin, &x_end);
+    covered_pixels(y0, y1, canvas->h, &y_begin, &y_end);
+
+    if ((x_begin >= x_end) || (y_begin >= y_end)) {
+        return;
+    }
+
+    color_factors(&v[0].color, k);
+
+    if (texture == NULL) {
+        for (int y = y_begin; y < y_end; y++) {
+            Uint32* dst = canvas_row(canvas, y);
+
+            for (int x = x_begin; x < x_end; x++) {
+                blend_into(&dst[x], 0xFFFFFFFF, k);
+            }
+        }
+
+        return;
+    }
+
+    // Texture coordinates are sampled at pixel centers
+    const float ds = (s1 - s0) / (x1 - x0);
+    const float dt = (t1 - t0) / (y1 - y0);
+
+    for (int x = x_begin; x < x_end; x++) {
+        texels_x[x] = texel_coord(s0 + (x + 0.5f - x0) * ds, texture->w);
+    }
+
+    for (int y = y_begin; y < y_end; y++) {
+        const Uint32* src = texture_row(texture, texel_coord(t0 + (y + 0.5f - y0) * dt, texture->h));
+        Uint32* dst = canvas_row(canvas, y);
+
+        for (int x = x_begin; x < x_end; x++) {
+            blend_into(&dst[x], src[texels_x[x]], k);
+        }
+    }
+}
+
+static float edge_function(const SDL_FPoint* a, const SDL_FPoint* b, float x, float y) {
+    return (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+}
+
+/// Top and left edges own the pixels centered exactly on them, so that triangles
+/// sharing an edge don't both draw those pixels.
+static bool is_top_left(const SDL_FPoint* a, const SDL_FPoint* b) {
+    const float dx = b->x - a->x;
+    const float dy = b->y - a->y;
+    return ((dy == 0) && (dx > 0)) || (dy < 0);
+}
+
+static bool is_covered(float w, bool top_left) {
+    return (w > 0) || ((w == 0) && top_left);
+}
+
+static void draw_triangle(SDL_Surface* canvas, const SDL_Surface* texture, const SDL_Vertex* a, const SDL_Vertex* b,
+                          const SDL_Vertex* c) {
+    float area = edge_function(&a->position, &b->position, c->position.x, c->position.y);
+
+    if (area == 0) {
+        return;
+    }
+
+    if (area < 0) {
+        const SDL_Vertex* tmp = b;
+        b = c;
+        c = tmp;
+        area = -area;
+    }
+
+    const SDL_FPoint* pa = &a->position;
+    const SDL_FPoint* pb = &b->position;
+    const SDL_FPoint* pc = &c->position;
+    const bool top_left_bc = is_top_left(pb, pc);
+    const bool top_left_ca = is_top_left(pc, pa);
+    const bool top_left_ab = is_top_left(pa, pb);
+    int x_begin;
+    int x_end;
+    int y_begin;
+    int y_end;
+
+    covered_pixels(SDL_min(pa->x, SDL_min(pb->x, pc->x)), SDL_max(pa->x, SDL_max(pb->x, pc->x)) + 1, canvas->w,
+                   &x_begin, &x_end);
+    covered_pixels(SDL_min(pa->y, SDL_min(pb->y, pc->y)), SDL_max(pa->y, SDL_max(pb->y, pc->y)) + 1, canvas->h,
+                   &y_begin, &y_end);
+
+    for (int y = y_begin; y < y_end; y++) {
+        Uint32* dst = canvas_row(canvas, y);
+        const float py = y + 0.5f;
+
+        for (int x = x_begin; x < x_end; x++) {
+            const float px = x + 0.5f;
+            const float wa = edge_function(pb, pc, px, py);
+            const float wb = edge_function(pc, pa, px, py);
+            const float wc = edge_function(pa, pb, px, py);
+
+            if (!is_covered(wa, top_left_bc) || !is_covered(wb, top_left_ca) || !is_covered(wc, top_left_ab)) {
+                continue;
+            }
+
+            const float la = wa / area;
+            const float lb = wb / area;
+            const float lc = wc / area;
+            const SDL_FColor color = {
+                .r = a->color.r * la + b->color.r * lb + c->color.r * lc,
+                .g = a->color.g * la + b->color.g * lb + c->color.g * lc,
+                .b = a->color.b * la + b->color.b * lb + c->color.b * lc,
+                .a = a->color.a * la + b->color.a * lb + c->color.a * lc,
+            };
+            Uint32 texel = 0xFFFFFFFF;
+            float k[4];
+
+            if (texture != NULL) {
+                const float s = a->tex_coord.x * la + b->tex_coord.x * lb + c->tex_coord.x * lc;
+                const float t = a->tex_coord.y * la + b->tex_coord.y * lb + c->tex_coord.y * lc;
+                texel = texture_row(texture, texel_coord(t, texture->h))[texel_coord(s, texture->w)];
+            }
+
+            color_factors(&color, k);
+            blend_into(&dst[x], texel, k);
+        }
+    }
+}
+
+void SoftRasterizer_Clear(SDL_Surface* canvas, Uint32 argb) {
+    SDL_FillSurfaceRect(canvas, NULL, argb);
+}
+
+void SoftRasterizer_DrawQuad(SDL_Surface* canvas, const SDL_Surface* texture, const SDL_Vertex* vertices) {
+    if (is_simple_rect(vertices)) {
+        draw_rect(canvas, texture, vertices);
+    } else {
+        draw_triangle(canvas, texture, &vertices[0], &vertices[1], &vertices[2]);
+        draw_triangle(canvas, texture, &vertices[1], &vertices[2], &vertices[3]);
+    }
+}
@@ -307,7 +307,14 @@ static void track_init(ADXTrack* track, int file_id, void* buf, size_t buf_size,
         fatal_error("One of file_id or buf must be valid.");
     }
 
-    if (file_id != -1) {
+    const void* mapped_data = (file_id != -1) ? AFS_GetFileData(file_id) : NULL;
+
+    if (mapped_data != NULL) {
+        // The decoder only reads, so it can use the archive directly
+        track->data = (uint8_t*)mapped_data;
+        track->size = AFS_GetSize(file_id);
+        track->should_free_data_after_use = false;
+    } else if (file_id != -1) {
         track->data = load_file(file_id, &track->size);
         track->should_free_data_after_use = true;
     } else {
@@ -1,5 +1,6 @@
 #include "sf33rd/Source/Common/PPGFile.h"
 #include "common.h"
+#include "port/io/decode_cache.h"
 #include "port/sdl/sdl_game_renderer.h"
 #include "sf33rd/AcrSDK/common/plcommon.h"
 #include "sf33rd/AcrSDK/ps2/flps2render.h"
@@ -8,6 +9,7 @@
 #include "sf33rd/Source/Common/MemMan.h"
 #include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
 #include "sf33rd/Source/Compress/zlibApp.h"
+#include "sf33rd/utils/xxhash64.h"
 #include "structs.h"
 
 #include <SDL3/SDL.h>
@@ -431,7 +433,7 @@ ssize_t ppgDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32
         break;
 
     case 1:
-        rnum = decLZ77withSizeCheck(srcAdrs, dstAdrs, dstSize);
+        rnum = decLZ77withBoundsCheck(srcAdrs, srcSize, dstAdrs, dstSize);
         rnum *= dstSize;
         break;
 
@@ -443,6 +445,40 @@ ssize_t ppgDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32
     return rnum;
 }
 
+/// Decompress a chunk and, if `convert` is set, put it in native byte order with `ppgChangeDataEndian`.
+/// Compressed chunks are looked up in the decoded asset cache first, keyed by a hash of their
+/// contents and of how they're decoded, and stored there after decoding.
+/// @return `true` if the chunk decoded to `dstSize` bytes.
+static bool ppgDecodeChunk(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32 dstSize, bool convert,
+                           s32 dendL, s32 col4, s32 depth) {
+    const s32 params[7] = { koCmpr, srcSize, dstSize, convert, dendL, col4, depth };
+    const bool cacheable = (koCmpr != 0) && (srcSize > 0) && DecodeCache_IsEnabled();
+    u64 key = 0;
+
+    if (cacheable) {
+        key = xxh64(srcAdrs, srcSize, xxh64((const u8*)params, sizeof(params), 0));
+
+        if (DecodeCache_Load(key, dstAdrs, dstSize)) {
+            return true;
+        }
+    }
+
+    if (dstSize != ppgDecompress(koCmpr, srcAdrs, srcSize, dstAdrs, dstSize)) {
+        return false;
+    }
+
+    if (convert) {
+        ppgChangeDataEndian(dstAdrs, dstSize, dendL, col4, depth, 0);
+    }
+
+    if (cacheable) {
+        DecodeCache_Store(key, dstAdrs, dstSize);
+    }
+
+    return true;
+}
+
+/// @return 1 on success, 0 if the chunk is damaged, -1 if there's no chunk `num`.
 s32 ppgSetupCmpChunk(u8* srcAdrs, s32 num, u8* dstAdrs) {
     PPXFileHeader* ppx;
     void* cmpAdrs;
@@ -479,9 +515,9 @@ s32 ppgSetupCmpChunk(u8* srcAdrs, s32 num, u8* dstAdrs) {
     cmpAdrs = ppx + 1;
     koCmpr = ppx->compress & 3;
 
-    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, dstAdrs, mltSize)) {
+    if (!ppgDecodeChunk(koCmpr, cmpAdrs, cmpSize, dstAdrs, mltSize, false, 0, 0, 0)) {
         flLogOut("圧縮データの解凍に失敗しました。\n"); // Failed to decompress the compressed data.
-        while (1) {}
+        return 0;
     }
 
     return 1;
@@ -564,14 +600,20 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
             goto error_handler;
         }
 
-        if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
+        if (!ppgDecodeChunk(koCmpr,
+                            cmpAdrs,
+                            cmpSize,
+                            mltAdrs,
+                            mltSize,
+                            true,
+                            ppl->c_mode & 4,
+                            ppl->formARGB == 0x8888,
+                            bits.bitdepth)) {
             flLogOut("パレットデータの解凍に失敗しました。\n"); // Failed to decompress the palette data.
             ppgPushDecBuff(mltAdrs);
             goto error_handler;
         }
 
-        ppgChangeDataEndian(mltAdrs, mltSize, ppl->c_mode & 4, ppl->formARGB == 0x8888, bits.bitdepth, 0);
-
         if (koCmpr == 0) {
             ppl->c_mode |= 4;
         }
@@ -795,6 +837,13 @@ error_handler:
     while (1) {}
 }
 
+/// Tell the renderer which `side`x`side` block of the texture is rewritten.
+/// Dot data is laid out in rows of 256 pixels.
+static void markDotDataDirty(Texture* tch, s32 ix, u32 ofs, s32 side) {
+    const SDL_Rect rect = { .x = ofs & 0xFF, .y = ofs >> 8, .w = side, .h = side };
+    SDLGameRenderer_MarkTextureDirty(tch->handle[ix].b16[0], &rect);
+}
+
 void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size) {
     s32 ix;
     s32 i;
@@ -821,6 +870,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
 
             switch (size) {
             case 0x40:
+                markDotDataDirty(tch, ix, CODE_0(code), 8);
                 srcRam8 = (u8*)srcRam;
                 dstRam8 = (u8*)(tch->srcAdrs + tch->srcSize * ix + CODE_0(code));
 
@@ -835,6 +885,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
                 break;
 
             case 0x100:
+                markDotDataDirty(tch, ix, CODE_0(code), 16);
                 srcRam8 = (u8*)srcRam;
                 dstRam8 = (u8*)(tch->srcAdrs + tch->srcSize * ix + CODE_0(code));
 
@@ -849,6 +900,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
                 break;
 
             case 0x400:
+                markDotDataDirty(tch, ix, CODE_1(code), 32);
                 srcRam8 = (u8*)srcRam;
                 dstRam8 = (u8*)(tch->srcAdrs + tch->srcSize * ix + CODE_1(code));
                 tix = (u16*)dctex_linear;
@@ -864,6 +916,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
                 break;
 
             case 0x80:
+                markDotDataDirty(tch, ix, CODE_0(code), 8);
                 srcRam16 = (u16*)srcRam;
                 dstRam16 = (u16*)(tch->srcAdrs + tch->srcSize * ix + (CODE_0(code)) * 2);
 
@@ -878,6 +931,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
                 break;
 
             case 0x200:
+                markDotDataDirty(tch, ix, CODE_0(code), 16);
                 srcRam16 = (u16*)srcRam;
                 dstRam16 = (u16*)(tch->srcAdrs + tch->srcSize * ix + (CODE_0(code)) * 2);
 
@@ -892,6 +946,7 @@ void ppgRenewDotDataSeqs(Texture* tch, u32 gix, u32* srcRam, u32 code, u32 size)
                 break;
 
             case 0x800:
+                markDotDataDirty(tch, ix, CODE_1(code), 32);
                 srcRam16 = (u16*)srcRam;
                 dstRam16 = (u16*)(tch->srcAdrs + tch->srcSize * ix + (CODE_1(code)) * 2);
                 tix = (u16*)dctex_linear;
@@ -1118,8 +1173,6 @@ s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
     void* cmpAdrs;
     void* mltAdrs;
 
-    s32 unused_s5;
-
     if (tch == NULL) {
         tch = ppg_w.cur->tex;
     }
@@ -1155,15 +1208,13 @@ s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
         while (1) {}
     }
 
-    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
+    if (!ppgDecodeChunk(
+            koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize, true, ppg->pixel & 4, ppg->formARGB == 0x8888, bits.bitdepth)) {
         // Failed to acquire sprite texture handle.
         flLogOut("テクスチャデータの解凍に失敗しました。\n");
         ppgPushDecBuff(mltAdrs);
         while (1) {}
     }
-
-    unused_s5 = 0;
-    ppgChangeDataEndian(mltAdrs, mltSize, ppg->pixel & 4, ppg->formARGB == 0x8888, bits.bitdepth, unused_s5);
     bits.ptr = mltAdrs;
     hnof->b16[0] = flCreateTextureHandle(&bits, attribute);
     ppgPushDecBuff(mltAdrs);
@@ -1,19 +1,87 @@
 #include "sf33rd/Source/Compress/Lz77/Lz77Dec.h"
 #include "common.h"
 
-s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+/// Copy `loop` bytes from `offset` bytes back. Like the original byte by byte copy, a match
+/// that overlaps the bytes it writes repeats the last `offset` bytes.
+static inline void copy_match(u8* dst, s32 offset, s32 loop, u8 step) {
+    const u8* dic = dst - offset;
+    s32 span = offset;
     s32 j;
+
+    if (step) {
+        for (j = 0; j < loop; j++) {
+            dst[j] = dic[j] + step;
+        }
+
+        return;
+    }
+
+    if (offset == 1) {
+        SDL_memset(dst, *dic, loop);
+        return;
+    }
+
+    // Each copy reads only bytes that are already written, and the written part repeats
+    // every `offset` bytes, so every copy can read twice as far back as the previous one
+    while (loop > 0) {
+        const s32 n = SDL_min(span, loop);
+
+        SDL_memcpy(dst, dst - span, n);
+        dst += n;
+        loop -= n;
+        span *= 2;
+    }
+}
+
+static inline void fill_ramp(u8* dst, u8 num, u8 step, s32 loop) {
+    s32 j;
+
+    for (j = 0; j < loop; j++) {
+        dst[j] = num;
+        num += step;
+    }
+}
+
+/// Decoder shared by both entry points. With `checked` set, every read is checked against
+/// `src_end` and every match against the start of `dst`. Writes are always checked.
+static inline s32 decode(const u8* src, const u8* src_end, u8* dst, s32 size, bool checked) {
+    u8* const dst_begin = dst;
+    u8* const dst_end = dst + size;
     s32 loop;
-    u8* dic;
     u8 num;
     u8 step;
     u16 offset;
 
-    while (size > 0) {
+    if (size < 0) {
+        return 0;
+    }
+
+#define NEED_SRC(n)                                                                                                    \
+    if (checked && ((src_end - src) < (n))) {                                                                          \
+        return 0;                                                                                                      \
+    }
+
+#define NEED_DST(n)                                                                                                    \
+    if ((dst_end - dst) < (n)) {                                                                                       \
+        return 0;                                                                                                      \
+    }
+
+#define NEED_DIC(n)                                                                                                    \
+    if (checked && ((dst - dst_begin) < (n))) {                                                                        \
+        return 0;                                                                                                      \
+    }
+
+    while (dst < dst_end) {
+        NEED_SRC(1);
         offset = *src++;
 
         if (offset & 0x80) {
             if (offset & 0x40) {
+                NEED_SRC(2);
                 offset = ((offset << 8) | *src++) & 0x3FFF;
 
                 if (offset == 0) {
@@ -23,6 +91,7 @@ s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
                 loop = *src++;
 
                 if (loop & 0x80) {
+                    NEED_SRC(1);
                     step = *src++;
                 } else {
                     step = 0;
@@ -34,119 +103,95 @@ s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
                     loop = 0x80;
                 }
 
-                dic = dst - offset;
-
-                if (step) {
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = *dic + step;
-                        dic++;
-                    }
-                } else {
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = *dic++;
-                    }
-                }
-
-                size -= loop;
+                NEED_DST(loop);
+                NEED_DIC(offset);
+                copy_match(dst, offset, loop, step);
+                dst += loop;
             } else {
                 switch (offset & 0x3F) {
                 case 1:
-                    loop = *src++;
-
-                    if (loop == 0) {
-                        loop = 0x100;
-                    }
-
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = *src++;
-                    }
-
-                    size -= loop;
-                    break;
-
                 case 2:
-                    loop = (src[0] << 8) | src[1];
-                    src += 2;
-
-                    if (loop == 0) {
-                        loop = 0x10000;
-                    }
-
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = *src++;
+                    if ((offset & 0x3F) == 1) {
+                        NEED_SRC(1);
+                        loop = *src++;
+
+                        if (loop == 0) {
+                            loop = 0x100;
+                        }
+                    } else {
+                        NEED_SRC(2);
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+
+                        if (loop == 0) {
+                            loop = 0x10000;
+                        }
                     }
 
-                    size -= loop;
+                    NEED_SRC(loop);
+                    NEED_DST(loop);
+                    SDL_memcpy(dst, src, loop);
+                    src += loop;
+                    dst += loop;
                     break;
 
                 case 3:
-                    num = *src++;
-                    loop = *src++;
-
-                    if (loop == 0) {
-                        loop = 0x100;
-                    }
-
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = num;
-                    }
-
-                    size -= loop;
-                    break;
-
                 case 4:
-                    num = *src++;
-                    loop = (src[0] << 8) | src[1];
-                    src += 2;
-
-                    if (loop == 0) {
-                        loop = 0x10000;
+                    if ((offset & 0x3F) == 3) {
+                        NEED_SRC(2);
+                        num = *src++;
+                        loop = *src++;
+
+                        if (loop == 0) {
+                            loop = 0x100;
+                        }
+                    } else {
+                        NEED_SRC(3);
+                        num = *src++;
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+
+                        if (loop == 0) {
+                            loop = 0x10000;
+                        }
                     }
 
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = num;
-                    }
-
-                    size -= loop;
+                    NEED_DST(loop);
+                    SDL_memset(dst, num, loop);
+                    dst += loop;
                     break;
 
                 case 5:
-                    num = *src++;
-                    step = *src++;
-                    loop = *src++;
-
-                    if (loop == 0) {
-                        loop = 0x100;
-                    }
-
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = num;
-                        num += step;
-                    }
-
-                    size -= loop;
-                    break;
-
                 case 6:
-                    num = *src++;
-                    step = *src++;
-                    loop = (src[0] << 8) | src[1];
-                    src += 2;
-
-                    if (loop == 0) {
-                        loop = 0x10000;
-                    }
-
-                    for (j = 0; j < loop; j++) {
-                        *dst++ = num;
-                        num += step;
+                    if ((offset & 0x3F) == 5) {
+                        NEED_SRC(3);
+                        num = *src++;
+                        step = *src++;
+                        loop = *src++;
+
+                        if (loop == 0) {
+                            loop = 0x100;
+                        }
+                    } else {
+                        NEED_SRC(4);
+                        num = *src++;
+                        step = *src++;
+                        loop = (src[0] << 8) | src[1];
+                        src += 2;
+
+                        if (loop == 0) {
+                            loop = 0x10000;
+                        }
                     }
 
-                    size -= loop;
+                    NEED_DST(loop);
+                    fill_ramp(dst, num, step, loop);
+                    dst += loop;
                     break;
                 }
             }
         } else {
+            NEED_SRC(1);
             offset = (offset << 8) | *src++;
             loop = offset & 0xF;
 
@@ -160,15 +205,24 @@ s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
                 offset = 0x800;
             }
 
-            dic = dst - offset;
-
-            for (j = 0; j < loop; j++) {
-                *dst++ = *dic++;
-            }
-
-            size -= loop;
+            NEED_DST(loop);
+            NEED_DIC(offset);
+            copy_match(dst, offset, loop, 0);
+            dst += loop;
         }
     }
 
-    return size == 0;
+#undef NEED_SRC
+#undef NEED_DST
+#undef NEED_DIC
+
+    return 1;
+}
+
+s32 decLZ77withSizeCheck(u8* src, u8* dst, s32 size) {
+    return decode(src, NULL, dst, size, false);
+}
+
+s32 decLZ77withBoundsCheck(const u8* src, s32 srcSize, u8* dst, s32 dstSize) {
+    return decode(src, src + srcSize, dst, dstSize, true);
 }
@@ -29,13 +29,13 @@
 #include "sf33rd/Source/Game/stage/ta_sub.h"
 #include "sf33rd/Source/Game/system/work_sys.h"
 
-s8 Appear_car_stop[] = { 0, 0 };
-s8 Appear_hv[] = { 0, 0 };
-s8 Appear_free[] = { 0, 0 };
-s8 Appear_flag[] = { 0, 0 };
-s16 app_counter[] = { 0, 0 };
-s16 appear_work[] = { 0, 0 };
-s16 Appear_end;
+ATTR_GAME_STATE s8 Appear_car_stop[] = { 0, 0 };
+ATTR_GAME_STATE s8 Appear_hv[] = { 0, 0 };
+ATTR_GAME_STATE s8 Appear_free[] = { 0, 0 };
+ATTR_GAME_STATE s8 Appear_flag[] = { 0, 0 };
+ATTR_GAME_STATE s16 app_counter[] = { 0, 0 };
+ATTR_GAME_STATE s16 appear_work[] = { 0, 0 };
+ATTR_GAME_STATE s16 Appear_end;
 
 void appear_work_clear() {
     Appear_end = 0;
@@ -53,9 +53,9 @@ s16 win_select(PLW* /* unused */, s16 num);
 void bonus_game_win_pause(PLW* wk);
 void meta_win_pause(PLW* wk);
 
-s16 win_rno[2];
-s16 win_free[2];
-s16 poison_flag[2];
+ATTR_GAME_STATE s16 win_rno[2];
+ATTR_GAME_STATE s16 win_free[2];
+ATTR_GAME_STATE s16 poison_flag[2];
 
 const s16 winner_type_tbl[20] = { 6, 0, 0, 6, 2, 7, 9, 3, 4, 1, 12, 0, 5, 14, 8, 13, 6, 10, 11, 15 };
 
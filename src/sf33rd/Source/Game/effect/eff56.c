@@ -10,9 +10,9 @@
 #include "sf33rd/Source/Game/stage/bg.h"
 #include "sf33rd/Source/Game/ui/sc_sub.h"
 
-const u8* ci_pointer;
-u8 ci_col;
-u8 ci_timer;
+ATTR_GAME_STATE const u8* ci_pointer;
+ATTR_GAME_STATE u8 ci_col;
+ATTR_GAME_STATE u8 ci_timer;
 
 const u8 ci_color_tbl[26] = { 21, 2,  22, 2,  21, 2,  20, 2,  21, 2,  22, 2,  21,
                               2,  20, 2,  21, 2,  22, 2,  21, 2,  20, 2,  20, 255 };
@@ -8,7 +8,7 @@
 
 // sbss
 
-END_W end_w;
+ATTR_GAME_STATE END_W end_w;
 s16 e_line_step;
 s8 end_etc_flag;
 s8 ending_all_end;
@@ -16,14 +16,14 @@
 #include <SDL3/SDL.h>
 
 // sbss
-JudgeGals judge_gals[2];
-JudgeCom judge_com[2];
-s16 last_judge_dada[2][5];
+ATTR_GAME_STATE JudgeGals judge_gals[2];
+ATTR_GAME_STATE JudgeCom judge_com[2];
+ATTR_GAME_STATE s16 last_judge_dada[2][5];
 
 // bss
-GradeData judge_item[2][2];
-GradeFinalData judge_final[2][2];
-u8 ji_sat[2][384];
+ATTR_GAME_STATE GradeData judge_item[2][2];
+ATTR_GAME_STATE GradeFinalData judge_final[2][2];
+ATTR_GAME_STATE u8 ji_sat[2][384];
 
 const s16 ji_grd_init_data[16] = { 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 1, 1, 1, 1, 1, 1 };
 
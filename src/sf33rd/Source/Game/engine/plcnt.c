@@ -76,27 +76,27 @@ s16 remake_sa_gauge_len(s16 ix, s16 gauge_len);
 void clear_super_arts_point(PLW* wk);
 void set_scrrrl();
 
-PLW plw[2];
-ZanzouTableEntry zanzou_table[2][48];
-SA_WORK super_arts[2];
-PiyoriType piyori_type[2];
-AppearanceType appear_type;
-s16 pcon_rno[4];
-bool round_slow_flag;
-bool pcon_dp_flag;
-u8 win_sp_flag;
-bool dead_voice_flag;
-
-UNK_1 rambod[2];
-UNK_2 ramhan[2];
+ATTR_GAME_STATE PLW plw[2];
+ATTR_GAME_STATE ZanzouTableEntry zanzou_table[2][48];
+ATTR_GAME_STATE SA_WORK super_arts[2];
+ATTR_GAME_STATE PiyoriType piyori_type[2];
+ATTR_GAME_STATE AppearanceType appear_type;
+ATTR_GAME_STATE s16 pcon_rno[4];
+ATTR_GAME_STATE bool round_slow_flag;
+ATTR_GAME_STATE bool pcon_dp_flag;
+ATTR_GAME_STATE u8 win_sp_flag;
+ATTR_GAME_STATE bool dead_voice_flag;
+
+ATTR_GAME_STATE UNK_1 rambod[2];
+ATTR_GAME_STATE UNK_2 ramhan[2];
 u32 omop_spmv_ng_table[2];  // FIXME: might not be necessary to put in GameState
 u32 omop_spmv_ng_table2[2]; // FIXME: might not be necessary to put in GameState
-u16 vital_inc_timer;
-u16 vital_dec_timer;
-char cmd_sel[2];
+ATTR_GAME_STATE u16 vital_inc_timer;
+ATTR_GAME_STATE u16 vital_dec_timer;
+ATTR_GAME_STATE char cmd_sel[2];
 s8 vib_sel[2];
-s16 sag_inc_timer[2];
-char no_sa[2];
+ATTR_GAME_STATE s16 sag_inc_timer[2];
+ATTR_GAME_STATE char no_sa[2];
 
 void plcnt_init();
 void plcnt_move();
@@ -7,9 +7,9 @@
 #include "common.h"
 #include "sf33rd/Source/Game/engine/workuser.h"
 
-s16 EXE_flag;
-s16 SLOW_flag;
-s16 SLOW_timer;
+ATTR_GAME_STATE s16 EXE_flag;
+ATTR_GAME_STATE s16 SLOW_flag;
+ATTR_GAME_STATE s16 SLOW_timer;
 
 const s8 slow_timer_to_flag[32] = { 1, 1, 1, 1, 1, 1, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
                                     3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 };
@@ -13,21 +13,21 @@
 #include "sf33rd/Source/Game/system/sysdir.h"
 #include "sf33rd/Source/Game/ui/sc_sub.h"
 
-s8 Old_Stop_SG;
-s8 Exec_Wipe_F;
-s8 time_clear[2];
-s16 spg_number;
-s16 spg_work;
-s16 spg_offset;
-s8 time_num;
-s8 time_timer;
-s8 time_flag[2];
-s16 col;
-s8 time_operate[2];
-s8 sast_now[2];
-s8 max2[2];
-s8 max_rno2[2];
-SPG_DAT spg_dat[2];
+ATTR_GAME_STATE s8 Old_Stop_SG;
+ATTR_GAME_STATE s8 Exec_Wipe_F;
+ATTR_GAME_STATE s8 time_clear[2];
+ATTR_GAME_STATE s16 spg_number;
+ATTR_GAME_STATE s16 spg_work;
+ATTR_GAME_STATE s16 spg_offset;
+ATTR_GAME_STATE s8 time_num;
+ATTR_GAME_STATE s8 time_timer;
+ATTR_GAME_STATE s8 time_flag[2];
+ATTR_GAME_STATE s16 col;
+ATTR_GAME_STATE s8 time_operate[2];
+ATTR_GAME_STATE s8 sast_now[2];
+ATTR_GAME_STATE s8 max2[2];
+ATTR_GAME_STATE s8 max_rno2[2];
+ATTR_GAME_STATE SPG_DAT spg_dat[2];
 
 const u16 spgauge_tbl[9] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
 
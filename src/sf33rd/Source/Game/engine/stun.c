@@ -12,7 +12,7 @@
 #include "sf33rd/Source/Game/system/work_sys.h"
 #include "sf33rd/Source/Game/ui/sc_sub.h"
 
-SDAT sdat[2];
+ATTR_GAME_STATE SDAT sdat[2];
 
 void stngauge_cont_init() {
     u8 i;
@@ -12,7 +12,7 @@
 #include "sf33rd/Source/Game/system/work_sys.h"
 #include "sf33rd/Source/Game/ui/sc_sub.h"
 
-VIT vit[2];
+ATTR_GAME_STATE VIT vit[2];
 
 void vital_cont_init() {
     u8 i;
@@ -17,6 +17,9 @@
 #include "structs.h"
 
 #include "port/io/afs.h"
+#include "port/io/afs_prefetch.h"
+
+#include <SDL3/SDL.h>
 
 typedef struct {
     u8 type;
@@ -38,6 +41,14 @@ u8 ldreq_result[294];
 
 static AFSHandle afs_handle = AFS_NONE;
 
+// Bounds how many times the queue's state machines are stepped in one frame
+#define LDREQ_STEPS_PER_FRAME_MAX 64
+
+#if defined(DEBUG)
+static Uint64 ldreq_begin_ns = 0;
+static AFSPrefetchStats ldreq_begin_stats;
+#endif
+
 // forward decls
 s32 Push_LDREQ_Queue(REQ* ldreq);
 void Push_LDREQ_Queue_Metamor();
@@ -357,24 +368,99 @@ s32 Push_LDREQ_Queue(REQ* ldreq) {
     return 0;
 }
 
-void Check_LDREQ_Queue() {
+#if defined(DEBUG)
+/// Log how long the queue took to empty, and how many of its reads were prefetched.
+static void time_ldreq_queue() {
+    const bool busy = q_ldreq->be != 0;
+
+    if (busy && (ldreq_begin_ns == 0)) {
+        ldreq_begin_ns = SDL_GetTicksNS();
+        ldreq_begin_stats = AFSPrefetch_GetStats();
+    } else if (!busy && (ldreq_begin_ns != 0)) {
+        const AFSPrefetchStats stats = AFSPrefetch_GetStats();
+
+        SDL_Log("[ldreq] Loads took %.1f ms, prefetch hits %d, late %d, misses %d",
+                (SDL_GetTicksNS() - ldreq_begin_ns) / 1e6,
+                stats.hits - ldreq_begin_stats.hits,
+                stats.late - ldreq_begin_stats.late,
+                stats.misses - ldreq_begin_stats.misses);
+
+        ldreq_begin_ns = 0;
+    }
+}
+#endif
+
+static s32 ldreq_file_number(u8 type, u8 ix);
+
+/// Have the files of the requests behind the head read in the background, nearest first,
+/// while the head is read and handed over.
+static void prefetch_ldreq_queue() {
     s16 i;
+    s32 fnum;
 
-    disp_ldreq_status();
+    // The prefetcher reads the files it was asked for last first
+    for (i = 15; i > 0; i--) {
+        if (q_ldreq[i].be == 0) {
+            continue;
+        }
 
-    if (!ldreq_break) {
-        if (q_ldreq->be != 0) {
-            ldreq_process[q_ldreq->type](q_ldreq);
+        fnum = ldreq_file_number(q_ldreq[i].type, q_ldreq[i].ix);
 
-            if (q_ldreq->be == 0) {
-                for (i = 0; i < 15; i++) {
-                    q_ldreq[i] = q_ldreq[i + 1];
-                }
+        if (fnum >= 0) {
+            AFS_Prefetch(fnum);
+        }
+    }
+}
+
+/// Step the head of the queue until it has to wait, moving on to the next request each time one finishes.
+/// Requests still finish one after another, in the order they were pushed.
+static void step_ldreq_queue() {
+    s16 i;
+    s16 steps;
+    u8 rno;
+    s32 fnum;
+
+    for (steps = 0; (steps < LDREQ_STEPS_PER_FRAME_MAX) && (q_ldreq->be != 0); steps++) {
+        if (q_ldreq->rno == 0) {
+            fnum = ldreq_file_number(q_ldreq->type, q_ldreq->ix);
+
+            // Reading it again would take longer than waiting for it
+            if ((fnum >= 0) && AFS_IsPrefetching(fnum)) {
+                break;
+            }
+        }
+
+        rno = q_ldreq->rno;
+        ldreq_process[q_ldreq->type](q_ldreq);
 
-                q_ldreq[i].be = 0;
-                q_ldreq[i].type = 0;
+        if (q_ldreq->be == 0) {
+            for (i = 0; i < 15; i++) {
+                q_ldreq[i] = q_ldreq[i + 1];
             }
 
+            q_ldreq[i].be = 0;
+            q_ldreq[i].type = 0;
+            continue;
+        }
+
+        // The request is waiting for a read or a transfer
+        if (q_ldreq->rno == rno) {
+            break;
+        }
+    }
+}
+
+void Check_LDREQ_Queue() {
+    disp_ldreq_status();
+
+#if defined(DEBUG)
+    time_ldreq_queue();
+#endif
+
+    if (!ldreq_break) {
+        if (q_ldreq->be != 0) {
+            prefetch_ldreq_queue();
+            step_ldreq_queue();
             return;
         }
     } else {
@@ -459,6 +545,57 @@ s32 Check_LDREQ_Queue_Direct(s16 ix) {
     return 1;
 }
 
+/// @return AFS file read by a load request of `type` for `ix`, -1 if it doesn't read one.
+static s32 ldreq_file_number(u8 type, u8 ix) {
+    u16 fnum;
+
+    switch (type) {
+    case 1:
+        return texgrpdat[ix].apfn;
+
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+        fnum = get_color_file_number(ix);
+        return (fnum != 0xFFFF) ? fnum : -1;
+
+    default:
+        return -1;
+    }
+}
+
+static void prefetch_ldreq_union(s16 ix) {
+    s16 i;
+    s16 kara;
+    s16 made;
+
+    if ((ix < 0) || (ix >= (s16)(sizeof(ldreq_ix) / sizeof(ldreq_ix[0])))) {
+        return;
+    }
+
+    kara = ldreq_ix[ix][0];
+    made = kara + ldreq_ix[ix][1];
+
+    for (i = kara; i < made; i++) {
+        const s32 fnum = ldreq_file_number(ldreq_tbl[i].type, ldreq_tbl[i].ix);
+
+        if (fnum >= 0) {
+            AFS_Prefetch(fnum);
+        }
+    }
+}
+
+/// Start reading the files `Push_LDREQ_Queue_Player` would load for `ix` in the background.
+void Prefetch_LDREQ_Player(s16 ix) {
+    prefetch_ldreq_union(ix);
+}
+
+/// Start reading the files `Push_LDREQ_Queue_BG` would load for `ix` in the background.
+void Prefetch_LDREQ_BG(s16 ix) {
+    prefetch_ldreq_union(ix + 20);
+}
+
 void q_ldreq_error(REQ* curr) {
     curr->be = 0;
     flLogOut("Q_LDREQ_ERROR : ロード処理の指定に誤りがあります。\n");
@@ -32,5 +32,7 @@ void Push_LDREQ_Queue_Player(s16 id, s16 ix);
 void Push_LDREQ_Queue_BG(s16 ix);
 s32 Check_LDREQ_Queue_BG(s16 ix);
 s32 Check_LDREQ_Queue_Direct(s16 ix);
+void Prefetch_LDREQ_Player(s16 ix);
+void Prefetch_LDREQ_BG(s16 ix);
 
 #endif
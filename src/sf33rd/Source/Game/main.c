@@ -1,6 +1,10 @@
 #include "sf33rd/Source/Game/main.h"
 #include "common.h"
 #include "netplay/netplay.h"
+#include "port/config.h"
+#include "port/io/decode_cache.h"
+#include "port/lz77_check.h"
+#include "port/paths.h"
 #include "port/sdl/sdl_app.h"
 #include "sf33rd/AcrSDK/common/mlPAD.h"
 #include "sf33rd/AcrSDK/ps2/flps2debug.h"
@@ -103,10 +107,29 @@ static bool run_resource_flow() {
 
 static void afs_init() {
     char* file_path = Resources_GetPath("SF33RD.AFS");
-    AFS_Init(file_path);
+    AFS_Init(file_path, Config_GetBool(CFG_KEY_MAP_AFS));
+    AFS_SetPrefetchBudget((size_t)SDL_max(Config_GetInt(CFG_KEY_AFS_PREFETCH_MB), 0) * 1024 * 1024);
+    DecodeCache_Init(Paths_GetPrefPath(), (size_t)SDL_max(Config_GetInt(CFG_KEY_DECODE_CACHE_MB), 0) * 1024 * 1024);
     SDL_free(file_path);
 }
 
+/// Check and benchmark the LZ77 decoder on the archive instead of running the game.
+static int run_lz77_check(int fuzz_iterations) {
+    bool passed = false;
+
+    if (Resources_CheckIfPresent()) {
+        afs_init();
+        passed = LZ77Check_Run(fuzz_iterations);
+        DecodeCache_Finish();
+        AFS_Finish();
+    } else {
+        SDL_Log("Game resources are missing, run the game once to set them up");
+    }
+
+    SDLApp_Quit();
+    return passed ? 0 : 1;
+}
+
 static void step_0() {
     if (!run_resource_flow()) {
         return;
@@ -134,14 +157,38 @@ static void step_1() {
 
 int main(int argc, char* argv[]) {
     bool is_running = true;
+    int exit_status = 0;
 
     init_windows_console();
     SDLApp_Init();
-
-    if (argc >= 3) {
+    Netplay_SetRunAhead(Config_GetInt(CFG_KEY_RUN_AHEAD));
+    Netplay_SetDesyncDetection(Config_GetBool(CFG_KEY_DESYNC_DETECTION));
+
+    if ((argc >= 2) && (SDL_strcmp(argv[1], "--sync-test") == 0)) {
+        const int frames = (argc >= 3) ? SDL_atoi(argv[2]) : 1;
+        const int frame_count = (argc >= 4) ? SDL_atoi(argv[3]) : SYNC_TEST_FRAME_COUNT_DEFAULT;
+        const Uint64 seed = (argc >= 5) ? SDL_strtoull(argv[4], NULL, 0) : SDL_GetPerformanceCounter();
+        Netplay_SetSyncTest(frames, frame_count, seed);
+    } else if ((argc >= 2) && (SDL_strcmp(argv[1], "--lz77-check") == 0)) {
+        return run_lz77_check((argc >= 3) ? SDL_atoi(argv[2]) : LZ77_CHECK_FUZZ_ITERATIONS_DEFAULT);
+    } else if ((argc >= 3) && (SDL_strcmp(argv[1], "--spectate") == 0)) {
+        Netplay_SetSpectate(argv[2]);
+    } else if ((argc >= 3) && (SDL_strcmp(argv[1], "--watch") == 0)) {
+        Netplay_SetWatch(argv[2]);
+    } else if (argc >= 3) {
         const int player = SDL_atoi(argv[1]);
         const char* ip = argv[2];
         Netplay_SetParams(player, ip);
+
+        for (int i = 3; i + 1 < argc; i += 2) {
+            if (SDL_strcmp(argv[i], "--spectator") == 0) {
+                Netplay_AddSpectator(argv[i + 1]);
+            } else if (SDL_strcmp(argv[i], "--net-emulation") == 0) {
+                Netplay_SetNetworkEmulation(argv[i + 1]);
+            } else if (SDL_strcmp(argv[i], "--telemetry") == 0) {
+                Netplay_SetTelemetryFile(argv[i + 1]);
+            }
+        }
     }
 
     while (is_running) {
@@ -150,11 +197,17 @@ int main(int argc, char* argv[]) {
         step_0();
         SDLApp_EndFrame();
         step_1();
+
+        if (Netplay_GetSyncTestExitStatus() >= 0) {
+            exit_status = Netplay_GetSyncTestExitStatus();
+            break;
+        }
     }
 
+    DecodeCache_Finish();
     AFS_Finish();
     SDLApp_Quit();
-    return 0;
+    return exit_status;
 }
 
 static void init_windows_console() {
@@ -274,10 +327,7 @@ static void game_step_0() {
     if (Netplay_IsRunning()) {
         Netplay_Run();
     } else {
-        njUserMain();
-        seqsBeforeProcess();
-        njdp2d_draw();
-        seqsAfterProcess();
+        Netplay_StepOffline();
     }
 
     KnjFlush();
@@ -164,6 +164,10 @@ void q_ldreq_color_data(REQ* curr) {
     }
 }
 
+u16 get_color_file_number(u16 ix) {
+    return color_file[ix].apfn;
+}
+
 void load_any_color(u16 ix, u8 kokey) {
     col_file_data* cfn;
     s16 key;
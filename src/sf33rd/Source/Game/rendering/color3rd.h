@@ -8,6 +8,7 @@ extern u16 ColorRAM[512][64];
 extern Col3rd_W col3rd_w;
 
 void q_ldreq_color_data(REQ* curr);
+u16 get_color_file_number(u16 ix);
 void load_any_color(u16 ix, u8 kokey);
 void set_hitmark_color();
 void init_trans_color_ram(s16 id, s16 key, u8 type, u16 data);
@@ -22,18 +22,25 @@
 
 #include <SDL3/SDL.h>
 
+#include <stdbool.h>
+
 #define PRIO_BASE_SIZE 128
+#define SPRITE_CHIP_MAX 0x8000 // Chips past this are dropped
 
 typedef struct {
     Sprite2* chip;
     u16 sprTotal;
     u16 sprMax;
     s8 up[24];
+    s32 sprCapacity;
+    bool chipOnHeap; // `chip` outgrew the buffer from `seqsInitialize` and was moved to the heap
+    s32 sprDropped;
 } SpriteChipSet;
 
 // sbss
 s32 curr_bright;
 SpriteChipSet seqs_w;
+static s32 patcash_full_count;
 
 // bss
 f32 PrioBase[PRIO_BASE_SIZE];
@@ -454,6 +461,11 @@ void mlt_obj_trans_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             (void)dh;
 
             ix = get_free_patcash_index(mt->cpat);
+
+            if (ix < 0) {
+                return;
+            }
+
             cp = &mt->cpat->patt[ix];
             mt->cpat->adr[mt->cpat->kazu] = cp;
             mt->cpat->kazu += 1;
@@ -829,6 +841,11 @@ void mlt_obj_trans_cp3_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             (void)dh;
 
             ix = get_free_patcash_index(mt->cpat);
+
+            if (ix < 0) {
+                return;
+            }
+
             cp = &mt->cpat->patt[ix];
             mt->cpat->adr[mt->cpat->kazu] = cp;
             mt->cpat->kazu += 1;
@@ -1216,6 +1233,11 @@ void mlt_obj_trans_rgb_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             s32 dh;
 
             ix = get_free_patcash_index(mt->cpat);
+
+            if (ix < 0) {
+                return;
+            }
+
             cp = &mt->cpat->patt[ix];
             mt->cpat->adr[mt->cpat->kazu] = cp;
             mt->cpat->kazu += 1;
@@ -1556,12 +1578,21 @@ void seqsInitialize(void* adrs) {
 
     seqs_w.chip = (Sprite2*)adrs;
     seqs_w.sprMax = 0;
+    seqs_w.sprCapacity = seqsGetUseMemorySize() / sizeof(Sprite2);
 }
 
 u16 seqsGetSprMax() {
     return seqs_w.sprMax;
 }
 
+s32 seqsGetSprDropped() {
+    return seqs_w.sprDropped;
+}
+
+s32 mltGetPatCashFullCount() {
+    return patcash_full_count;
+}
+
 u32 seqsGetUseMemorySize() {
     return 0xD000;
 }
@@ -1614,6 +1645,36 @@ void seqsAfterProcess() {
     }
 }
 
+/// Double the chip buffer. The game's memory only has room for 0x400 chips, crowded scenes continue on the heap.
+/// @return `false` if the buffer can't grow any further.
+static bool grow_chip_buffer() {
+    const s32 capacity = seqs_w.sprCapacity * 2;
+    Sprite2* chip;
+
+    if (capacity > SPRITE_CHIP_MAX) {
+        return false;
+    }
+
+    if (seqs_w.chipOnHeap) {
+        chip = SDL_realloc(seqs_w.chip, capacity * sizeof(Sprite2));
+    } else {
+        chip = SDL_malloc(capacity * sizeof(Sprite2));
+
+        if (chip != NULL) {
+            SDL_memcpy(chip, seqs_w.chip, seqs_w.sprTotal * sizeof(Sprite2));
+        }
+    }
+
+    if (chip == NULL) {
+        return false;
+    }
+
+    seqs_w.chip = chip;
+    seqs_w.sprCapacity = capacity;
+    seqs_w.chipOnHeap = true;
+    return true;
+}
+
 s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 alpha, s32 id) {
     Sprite2* chip;
     s32 u;
@@ -1622,6 +1683,16 @@ s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 a
     const f32 dx = 0;
     const f32 dy = 0;
 
+    if ((seqs_w.sprTotal == seqs_w.sprCapacity) && !grow_chip_buffer()) {
+        // The number of OBJ fragments has exceeded the planned number
+        if (seqs_w.sprDropped == 0) {
+            flLogOut("ＯＢＪの破片が予定数を越えてしまいました");
+        }
+
+        seqs_w.sprDropped += 1;
+        return 1;
+    }
+
     chip = &seqs_w.chip[seqs_w.sprTotal];
     chip->v[0].x = x;
     chip->v[0].y = y;
@@ -1667,13 +1738,6 @@ s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 a
     chip->vertex_color = curr_bright | ((0xFF - alpha) << 24);
     chip->id = id;
     seqs_w.sprTotal += 1;
-
-    if (seqs_w.sprTotal > 0x400) {
-        // The number of OBJ fragments has exceeded the planned number
-        flLogOut("ＯＢＪの破片が予定数を越えてしまいました");
-        while (1) {}
-    }
-
     return 1;
 }
 
@@ -1932,6 +1996,8 @@ static s16 check_patcash_ex_trans(PatternCollection* padr, u32 cg) {
     return rnum;
 }
 
+/// @return Index of a free pattern slot, -1 if all of them are in use.
+/// Objects that don't get a slot are left out until one frees up.
 static s32 get_free_patcash_index(PatternCollection* padr) {
     s16 i;
 
@@ -1941,8 +2007,12 @@ static s32 get_free_patcash_index(PatternCollection* padr) {
         }
     }
 
-    flLogOut("ＣＧキャッシュバッファが一杯になりました。\n");
-    while (1) {}
+    if (patcash_full_count == 0) {
+        flLogOut("ＣＧキャッシュバッファが一杯になりました。\n");
+    }
+
+    patcash_full_count += 1;
+    return -1;
 }
 
 static void lz_ext_p6_fx(u8* srcptr, u8* dstptr, u32 len) {
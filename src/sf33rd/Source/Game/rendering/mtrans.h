@@ -23,7 +23,16 @@ void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y);
 void mlt_obj_trans_rgb(MultiTexture* mt, WORK* wk, s32 base_y);
 void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y);
 void draw_box(f64 arg0, f64 arg1, f64 arg2, f64 arg3, u32 col, u32 attr, s16 prio);
+
+/// @return Most sprite chips any frame has stored.
 u16 seqsGetSprMax();
+
+/// @return Sprite chips that were left out because even the grown buffer was full.
+s32 seqsGetSprDropped();
+
+/// @return How many times an object was left out because its CG cache was full.
+s32 mltGetPatCashFullCount();
+
 s16 getObjectHeight(u16 cgnum);
 
 #endif
@@ -142,6 +142,36 @@ const u8 Repeat_Time_Data[3] = { 26, 9, 7 };
 
 const u8 Repeat_Time_Data_Wife[3] = { 1, 1, 1 };
 
+/// Start reading the files of the characters under the cursors and of the stage the match is likely on,
+/// so that they're in memory by the time the selection is confirmed.
+static void prefetch_selection() {
+    s16 id;
+    s16 char_ix;
+
+    for (id = 0; id < 2; id++) {
+        if (plw[id].wu.operator == 0) {
+            continue;
+        }
+
+        char_ix = ID_of_Face[Cursor_Y[id]][Cursor_X[id]];
+
+        if (char_ix < 0) {
+            continue;
+        }
+
+        Prefetch_LDREQ_Player(char_ix);
+
+        // Q has no stage of his own
+        if (Mode_Type != MODE_VERSUS && char_ix != 17) {
+            Prefetch_LDREQ_BG(char_ix);
+        }
+    }
+
+    if (Mode_Type == MODE_VERSUS && VS_Stage != 20) {
+        Prefetch_LDREQ_BG(VS_Stage);
+    }
+}
+
 s16 Select_Player() {
     SEL_PL_X = 0;
 
@@ -156,6 +186,7 @@ s16 Select_Player() {
     Sel_PL();
     ID = 1;
     Sel_PL();
+    prefetch_selection();
     Time_Over = false;
 
     if (Check_Exit_Check() == 0 && Debug_w[24] == -1) {
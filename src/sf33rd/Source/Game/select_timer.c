@@ -1,4 +1,5 @@
 #include "sf33rd/Source/Game/select_timer.h"
+#include "common.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 #include "sf33rd/Source/Game/engine/workuser.h"
 #include "types.h"
@@ -7,7 +8,7 @@
 
 #include <stdbool.h>
 
-SelectTimerState select_timer_state = { 0 };
+ATTR_GAME_STATE SelectTimerState select_timer_state = { 0 };
 static s16 bcdext = 0;
 
 static u8 sbcd(u8 a, u8 b) {
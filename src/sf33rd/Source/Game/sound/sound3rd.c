@@ -119,6 +119,7 @@ s8* csePHDDataTable[21] = { PHD_SE,   PHD_PL00, PHD_PL01, PHD_PL02, PHD_PL03, PH
                             PHD_PL13, PHD_PL14, PHD_PL15, PHD_PL16, PHD_PL17, PHD_PL18, PHD_PL19 };
 
 u8 adx_NowOnMemoryType = 0xFF;
+bool sound_requests_muted = false;
 
 BGMTableEntry* bgm_table[2] = { bgm_tableDC, bgm_tableAC };
 BGMExecutionData* bgm_exdata[2] = { bgm_exdataDC, bgm_exdataAC };
@@ -188,10 +189,15 @@ void checkAdxFileLoaded() {
     } while (key == 0);
 
     adr = (u8*)Get_ramcnt_address(key);
-    ppgSetupCmpChunk(adr, 0, adx_VS);
-    ppgSetupCmpChunk(adr, 1, adx_EmSel);
+
+    // If either track fails to decompress, both are streamed like the others instead
+    if ((ppgSetupCmpChunk(adr, 0, adx_VS) == 1) && (ppgSetupCmpChunk(adr, 1, adx_EmSel) == 1)) {
+        adx_NowOnMemoryType = sys_w.bgm_type;
+    } else {
+        adx_NowOnMemoryType = 0xFF;
+    }
+
     Push_ramcnt_key(key);
-    adx_NowOnMemoryType = sys_w.bgm_type;
 }
 
 void Exit_sound_system() {
@@ -245,6 +251,10 @@ void setupSoundMode() {
 }
 
 void sound_request_for_dc(SoundPatchConfig* rmc, s16 pan) {
+    if (sound_requests_muted) {
+        return;
+    }
+
     if (rmc->ptix != 0x7F) {
         if (pan < -0x20) {
             pan = -0x20;
@@ -4,12 +4,17 @@
 #include "structs.h"
 #include "types.h"
 
+#include <stdbool.h>
+
 extern s16 bgm_level;
 extern s16 se_level;
 extern s8* sdbd[3];
 extern SoundEvent* cseTSBDataTable[];
 extern s8* csePHDDataTable[];
 
+/// Drop sound requests, for frames that are simulated but never really happen.
+extern bool sound_requests_muted;
+
 void Init_sound_system();
 s32 sndCheckVTransStatus(s32 type);
 void sndInitialLoad();
@@ -14,15 +14,15 @@
 #include "sf33rd/Source/Game/ui/sc_data.h"
 #include "sf33rd/Source/Game/ui/sc_sub.h"
 
-s8 round_timer;
-s8 flash_timer;
-s8 flash_r_num;
-s8 flash_col;
-s8 math_counter_hi;
-s8 math_counter_low;
-u8 counter_color;
-bool mugen_flag;
-s8 hoji_counter;
+ATTR_GAME_STATE s8 round_timer;
+ATTR_GAME_STATE s8 flash_timer;
+ATTR_GAME_STATE s8 flash_r_num;
+ATTR_GAME_STATE s8 flash_col;
+ATTR_GAME_STATE s8 math_counter_hi;
+ATTR_GAME_STATE s8 math_counter_low;
+ATTR_GAME_STATE u8 counter_color;
+ATTR_GAME_STATE bool mugen_flag;
+ATTR_GAME_STATE s8 hoji_counter;
 
 void count_cont_init(u8 type) {
     if (Mode_Type == MODE_NETWORK) {
@@ -38,9 +38,9 @@ SAFrame sa_frame[3][48];
 
 // sbss
 Polygon scrscrntex[4];
-u8 WipeLimit;
-u8 FadeLimit;
-s16 Hnc_Num;
+ATTR_GAME_STATE u8 WipeLimit;
+ATTR_GAME_STATE u8 FadeLimit;
+ATTR_GAME_STATE s16 Hnc_Num;
 FadeData fd_dat;
 
 // forward decls
@@ -0,0 +1,104 @@
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// xxHash64 (https://github.com/Cyan4973/xxHash). Processes 32-byte stripes in four
+// independent lanes, so unlike djb2 there's no dependency chain from one byte to the next.
+
+#define XXH64_PRIME_1 0x9E3779B185EBCA87ULL
+#define XXH64_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define XXH64_PRIME_3 0x165667B19E3779F9ULL
+#define XXH64_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define XXH64_PRIME_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t xxh64_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t xxh64_read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t xxh64_read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH64_PRIME_2;
+    acc = xxh64_rotl(acc, 31);
+    return acc * XXH64_PRIME_1;
+}
+
+static inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val) {
+    acc ^= xxh64_round(0, val);
+    return acc * XXH64_PRIME_1 + XXH64_PRIME_4;
+}
+
+static inline uint64_t xxh64(const uint8_t* data, size_t len, uint64_t seed) {
+    const uint8_t* p = data;
+    const uint8_t* const end = data + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + XXH64_PRIME_1 + XXH64_PRIME_2;
+        uint64_t v2 = seed + XXH64_PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH64_PRIME_1;
+
+        do {
+            v1 = xxh64_round(v1, xxh64_read64(p));
+            v2 = xxh64_round(v2, xxh64_read64(p + 8));
+            v3 = xxh64_round(v3, xxh64_read64(p + 16));
+            v4 = xxh64_round(v4, xxh64_read64(p + 24));
+            p += 32;
+        } while (p <= end - 32);
+
+        h = xxh64_rotl(v1, 1) + xxh64_rotl(v2, 7) + xxh64_rotl(v3, 12) + xxh64_rotl(v4, 18);
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    } else {
+        h = seed + XXH64_PRIME_5;
+    }
+
+    h += len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64_round(0, xxh64_read64(p));
+        h = xxh64_rotl(h, 27) * XXH64_PRIME_1 + XXH64_PRIME_4;
+    }
+
+    if (p + 4 <= end) {
+        h ^= (uint64_t)xxh64_read32(p) * XXH64_PRIME_1;
+        h = xxh64_rotl(h, 23) * XXH64_PRIME_2 + XXH64_PRIME_3;
+        p += 4;
+    }
+
+    for (; p < end; p++) {
+        h ^= (*p) * XXH64_PRIME_5;
+        h = xxh64_rotl(h, 11) * XXH64_PRIME_1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH64_PRIME_2;
+    h ^= h >> 29;
+    h *= XXH64_PRIME_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/// Fold a 64-bit hash into 32 bits, e.g. for GekkoNet checksums.
+static inline uint32_t xxh64_fold32(uint64_t h) {
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+#endif
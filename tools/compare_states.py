@@ -246,6 +246,48 @@ class DWARFParser:
         for struct in self.structs:
             self.struct_name_to_struct[struct.name] = struct
 
+class ArenaSymbols:
+    """Resolves offsets inside GameState.data to the globals the linker put in the game_state section."""
+
+    def __init__(self, path: Path):
+        self.symbols: list[tuple[int, str]] = []
+        start: int | None = None
+
+        for line in self.__run_nm(path).splitlines():
+            parts = line.split()
+
+            if len(parts) != 3:
+                continue
+
+            address, _, name = parts
+
+            if name == "__start_game_state":
+                start = int(address, base=16)
+            else:
+                self.symbols.append((int(address, base=16), name))
+
+        if start == None:
+            raise RuntimeError("__start_game_state not found")
+
+        self.symbols = sorted((address - start, name) for address, name in self.symbols if address >= start)
+
+    def find(self, offset: int) -> str:
+        candidates = [x for x in self.symbols if x[0] <= offset]
+
+        if not candidates:
+            return f"data[0x{offset:X}]"
+
+        location, name = candidates[-1]
+        return f"{name}+0x{offset - location:X}"
+
+    def __run_nm(self, path: Path) -> str:
+        result = subprocess.run(["nm", "--defined-only", path], capture_output=True, text=True)
+
+        if result.returncode != 0:
+            raise RuntimeError(f"nm failed: {result.stderr.strip()}")
+
+        return result.stdout
+
 def find_state_pairs() -> list[tuple[Path, Path, int]]:
     pairs: list[tuple[Path, Path]] = []
     files = sorted(Path("states").iterdir(), key=lambda x: x.name)
@@ -281,7 +323,7 @@ def effect_offset(parser: DWARFParser, index: int) -> int:
 
     return offset
 
-def compare_states(parser: DWARFParser):
+def compare_states(parser: DWARFParser, arena: ArenaSymbols | None):
     pairs = find_state_pairs()
 
     for pl1_state_path, pl2_state_path, frame in pairs:
@@ -296,6 +338,12 @@ def compare_states(parser: DWARFParser):
 
             if byte1 != byte2:
                 path_components, metadata = parser.find_member("State", i)
+
+                if arena and path_components and path_components[0] == "gs":
+                    state_struct = parser.struct_name_to_struct.get("State")
+                    gs_offset = i - next(m for m in state_struct.members if m.name == "gs").location
+                    path_components = ["gs", arena.find(gs_offset)]
+
                 path = ".".join(path_components)
 
                 effect_id = None
@@ -313,13 +361,15 @@ def compare_states(parser: DWARFParser):
                 print(message)
 
 def main():
-    if len(sys.argv) != 2:
-        print("Usage: python3 compare_states.py <path_to_obj_file>")
+    if len(sys.argv) not in (2, 3):
+        print("Usage: python3 compare_states.py <path_to_obj_file> [path_to_executable]")
+        print("Pass the executable to resolve GameState offsets to global names")
         return
 
     parser = DWARFParser()
     parser.parse_object(Path(sys.argv[1]))
-    compare_states(parser)
+    arena = ArenaSymbols(Path(sys.argv[2])) if len(sys.argv) == 3 else None
+    compare_states(parser, arena)
 
 if __name__ == "__main__":
     main()